@@ -0,0 +1,74 @@
+#ifndef MAZE_ARENA_H
+#define MAZE_ARENA_H
+
+#include <cstddef>
+#include <vector>
+
+//
+// Monotonic ("bump pointer") allocator. Memory is handed out from
+// big blocks and only given back all at once, by release() or when the
+// Arena is destroyed.
+//
+// Used by MazeData to hold all the Nodes and their exits, so generating
+// a maze is a handful of allocations instead of a few per cell and
+// deleting it is just freeing the blocks.
+//
+// NOTE: Destructors of objects placed in the Arena are NOT called,
+//       so only put things there that don't own any other memory
+//
+namespace Maze {
+
+class Arena
+{
+public:
+    enum { DEFAULT_BLOCK_SIZE = 64*1024 };
+
+    explicit Arena(std::size_t blockSize = DEFAULT_BLOCK_SIZE);
+    ~Arena();
+
+    // Make sure the next numBytes of allocations come from one block
+    // i.e. if know roughly how much is needed then a single allocation
+    void reserve(std::size_t numBytes);
+
+    // Raw memory, aligned to align (which must be a power of 2 and
+    // no more than alignof(std::max_align_t))
+    void* allocate(std::size_t numBytes,
+                   std::size_t align = alignof(std::max_align_t));
+
+    // Uninitialised memory for count Ts
+    template <typename T>
+    T* allocate(int count = 1)
+    {
+        return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    // Free all the blocks
+    void release();
+
+    bool empty() const { return m_blocks.empty(); }
+
+    // Stats
+    int getNumBlocks() const { return m_blocks.size(); }
+    std::size_t getBytesUsed() const { return m_bytesUsed; }
+    std::size_t getBytesReserved() const { return m_bytesReserved; }
+
+protected:
+    void addBlock(std::size_t minBytes);
+
+protected:
+    std::vector<char*> m_blocks;
+    char*              m_pNext;
+    char*              m_pEnd;
+    std::size_t        m_blockSize;
+    std::size_t        m_bytesUsed;
+    std::size_t        m_bytesReserved;
+
+private:
+    // Can't copy the memory
+    Arena(const Arena&);
+    Arena& operator=(const Arena&);
+};
+
+} // namespace
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef MAZE_BATCH_GENERATOR_H
+#define MAZE_BATCH_GENERATOR_H
+
+#include <vector>
+
+#include "MazeData.h"
+
+//
+// Generates lots of mazes at once spread across a ThreadPool.
+//
+// Each thread has its own Generator (so its own scratch buffers) and
+// its own RNG::RandSimple, and each maze has its own MazeData (so its
+// own Arena). The RNG is initialised to the Job's seed before each
+// maze, so a maze is the same as a Generator with a RandSimple would
+// make for that seed on its own, whichever thread makes it.
+//
+namespace RNG { class I_Random; }
+
+namespace Maze {
+
+class Generator;
+class PackedMaze;
+class ThreadPool;
+
+class BatchGenerator
+{
+public:
+    struct Job {
+        MazeData     m_mazeData;   // Only the parameters are used
+        unsigned int m_seed;
+        Job(const MazeData& rMazeData, unsigned int seed) :
+            m_mazeData(rMazeData), m_seed(seed) { }
+    };
+    typedef std::vector<Job> JobList;
+
+    // numThreads of 0 => one per core
+    explicit BatchGenerator(int numThreads = 0);
+    virtual ~BatchGenerator();
+
+    int getNumThreads() const;
+
+    // Generate a maze for every Job. rResults[i] is the maze for rJobs[i]
+    // NOTE: These are new MazeDatas which must be deleted by caller
+    virtual void generate(const JobList& rJobs,
+                          std::vector<MazeData*>& rResults);
+
+    // As above but using Generator::generatePacked
+    // NOTE: These are new PackedMazes which must be deleted by caller
+    virtual void generatePacked(const JobList& rJobs,
+                                std::vector<PackedMaze*>& rResults);
+
+protected:
+    // The Generator for a thread set up for a Job
+    Generator& getGenerator(int thread, const Job& rJob);
+
+protected:
+    ThreadPool*                 m_pThreadPool;
+    // Per thread
+    std::vector<Generator*>     m_generators;
+    std::vector<RNG::I_Random*> m_rngs;
+
+private:
+    BatchGenerator(const BatchGenerator&);
+    BatchGenerator& operator=(const BatchGenerator&);
+};
+
+} // namespace
+
+#endif
@@ -0,0 +1,143 @@
+#ifndef MAZE_CELL_GRAPH_H
+#define MAZE_CELL_GRAPH_H
+
+#include <cstdint>
+#include <vector>
+
+//
+// The cells of a maze as indices 0..N-1 and which cell each exit of a
+// cell leads to, as a flat table. It is what the maze algorithms (see
+// I_MazeAlgorithm.h) work on instead of Nodes: Generator fills in the
+// table while making the Nodes then opens the Nodes' exits from it.
+//
+// Also keeps which cells are in the maze (so far) and which exits are
+// open, as bitsets. Opening an exit puts both cells in the maze.
+//
+// findExits() is the one way to look at a cell's neighbours. It is
+// written without branches on what it finds, since in a random maze
+// that is never predictable.
+//
+namespace RNG { class I_Random; }
+
+namespace Maze {
+class CounterRandom;
+
+class CellGraph
+{
+public:
+    // Which exits findExits() wants
+    enum Filter {
+        ALL_EXITS,      // Every exit that leads to a cell
+        IN_MAZE,        // Exits to cells already in the maze
+        NOT_IN_MAZE     // Exits to cells not in the maze yet
+    };
+
+    CellGraph();
+    ~CellGraph();
+
+    // numCells cells with maxExits exits each, all leading nowhere.
+    // No cells are in the maze and all exits are closed
+    void reset(int numCells, int maxExits);
+
+    // Forget the cells (keeps the storage for the next reset)
+    void clear();
+
+    bool empty() const { return m_exitCells.empty(); }
+    int getNumCells() const { return m_numCells; }
+    int getMaxExits() const { return m_maxExits; }
+
+    void setExitCell(int cell, int exitNum, int exitCell)
+    {
+        m_exitCells[cell * m_maxExits + exitNum] = exitCell;
+    }
+
+    // Cell the exit leads to or -1 if it leads nowhere
+    int getExitCell(int cell, int exitNum) const
+    {
+        const int l_exitCell = m_exitCells[cell * m_maxExits + exitNum];
+        return (l_exitCell == m_numCells) ? -1 : l_exitCell;
+    }
+
+    bool isInMaze(int cell) const
+    {
+        return (m_inMaze[cell >> 6] >> (cell & 63)) & 1;
+    }
+    void addToMaze(int cell)
+    {
+        m_inMaze[cell >> 6] |= (std::uint64_t(1) << (cell & 63));
+    }
+
+    bool isOpen(int cell, int exitNum) const
+    {
+        const int l_idx = cell * m_maxExits + exitNum;
+        return (m_openExits[l_idx >> 6] >> (l_idx & 63)) & 1;
+    }
+
+    // Open the exit and the exit back from the cell it leads to, and
+    // put both cells in the maze. If more than one exit leads back
+    // (e.g. a small wrapped maze) only this side is opened and the exit
+    // is listed in getUnpairedExits() for the caller to sort out
+    void openExit(int cell, int exitNum);
+
+    // Exits opened whose other side couldn't be worked out,
+    // as cell * getMaxExits() + exitNum
+    const std::vector<int>& getUnpairedExits() const
+    {
+        return m_unpairedExits;
+    }
+
+    // Find the exits of the cell that lead to a cell and pass the
+    // filter. Returns how many, see getFoundExit() for them (they are
+    // in exit number order)
+    int findExits(int cell, Filter filter)
+    {
+        const int* l_pExitCells = &m_exitCells[cell * m_maxExits];
+        int l_numFound = 0;
+        for (int i = 0; i < m_maxExits; ++i)
+        {
+            const int l_exitCell = l_pExitCells[i];
+            // Leading nowhere is a cell that is always in the maze
+            const bool l_inMaze = isInMaze(l_exitCell);
+            const bool l_wanted = (filter == NOT_IN_MAZE) ? not l_inMaze
+                : (l_exitCell != m_numCells)
+                  and ((filter == ALL_EXITS) or l_inMaze);
+            m_foundExits[l_numFound] = i;
+            l_numFound += l_wanted;
+        }
+        return l_numFound;
+    }
+    int getFoundExit(int found) const { return m_foundExits[found]; }
+
+    // findExits then pick one of them at random (one RNG call, none if
+    // there are none). Returns the exit number or -1 if none
+    int findRandomExit(int cell, Filter filter, RNG::I_Random& rRNG);
+    // As above picking with the PURPOSE_BACKTRACK draw for index (see
+    // CounterRandom)
+    int findRandomExit(int cell,
+                       Filter filter,
+                       const CounterRandom& rRNG,
+                       std::uint64_t index);
+
+    // The cell furthest from startCell following the open exits
+    int getFurthestCell(int startCell) const;
+
+    // Bytes of storage used
+    long getMemoryUsed() const;
+
+protected:
+    int m_numCells;
+    int m_maxExits;
+    // Cell each exit leads to (m_numCells if nowhere)
+    // as cell * m_maxExits + exitNum
+    std::vector<int>           m_exitCells;
+    // Bit per cell (plus one, always set, for m_numCells)
+    std::vector<std::uint64_t> m_inMaze;
+    // Bit per exit, as m_exitCells
+    std::vector<std::uint64_t> m_openExits;
+    std::vector<int>           m_unpairedExits;
+    std::vector<int>           m_foundExits;
+};
+
+} // namespace
+
+#endif
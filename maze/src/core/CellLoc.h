@@ -1,14 +1,301 @@
 #ifndef MAZE_CELL_LOC_H
 #define MAZE_CELL_LOC_H
 
+#include <algorithm>
+#include <assert.h>
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
 #include <vector>
 
+//
+// A Cell Location is a list of coordinates, one per dimension of the maze.
+//
+// It used to be a std::vector<int>, which meant a heap allocation for
+// every location made (every Node and every neighbour looked at). Now the
+// coordinates are stored inline (up to MAX_DIMS of them) so copying and
+// adding them never touches the heap. The std::vector style methods are
+// kept so code written against the old typedef still works, and it can
+// be converted to/from a std::vector<int>.
+//
+// Like the std::vector it can hold any number of coordinates: past
+// MAX_DIMS they all move to a std::vector on the heap (and stay there),
+// so only mazes with more dimensions than that pay for it.
+//
+// CellLocN<N> is a fixed rank version for code that knows the number of
+// dimensions at compile time. All its arithmetic is constexpr.
+//
 namespace Maze {
 
-typedef std::vector<int> CellLoc;
+class CellLoc
+{
+public:
+    enum { MAX_DIMS = 4 };
 
-CellLoc operator+(const CellLoc& rLHS, const CellLoc& rRHS);
-CellLoc& operator+=(CellLoc& rLHS, const CellLoc rRHS);
+    typedef int                 value_type;
+    typedef int&                reference;
+    typedef const int&          const_reference;
+    typedef int*                iterator;
+    typedef const int*          const_iterator;
+    typedef unsigned int        size_type;
+
+    CellLoc() : m_coords(), m_size(0), m_pMore(0) { }
+
+    explicit CellLoc(size_type numDims, int value = 0) :
+        m_coords(), m_size(0), m_pMore(0)
+    {
+        resize(numDims, value);
+    }
+
+    CellLoc(const CellLoc& rOther) :
+        m_size(rOther.m_size),
+        m_pMore(rOther.m_pMore ? new std::vector<int>(*rOther.m_pMore) : 0)
+    {
+        std::copy(rOther.m_coords, rOther.m_coords + MAX_DIMS, m_coords);
+    }
+
+    CellLoc(CellLoc&& rOther) noexcept :
+        m_size(rOther.m_size), m_pMore(rOther.m_pMore)
+    {
+        std::copy(rOther.m_coords, rOther.m_coords + MAX_DIMS, m_coords);
+        rOther.m_size = 0;
+        rOther.m_pMore = 0;
+    }
+
+    ~CellLoc() { delete m_pMore; }
+
+    CellLoc& operator=(const CellLoc& rOther)
+    {
+        if (rOther.m_pMore or m_pMore)
+        {
+            copyMore(rOther);
+        }
+        std::copy(rOther.m_coords, rOther.m_coords + MAX_DIMS, m_coords);
+        m_size = rOther.m_size;
+        return *this;
+    }
+
+    CellLoc& operator=(CellLoc&& rOther) noexcept
+    {
+        if (this != &rOther)
+        {
+            delete m_pMore;
+            std::copy(rOther.m_coords, rOther.m_coords + MAX_DIMS, m_coords);
+            m_size = rOther.m_size;
+            m_pMore = rOther.m_pMore;
+            rOther.m_size = 0;
+            rOther.m_pMore = 0;
+        }
+        return *this;
+    }
+
+    template <class InputItr,
+              class = typename std::enable_if<
+                  not std::is_integral<InputItr>::value>::type>
+    CellLoc(InputItr first, InputItr last) : m_coords(), m_size(0), m_pMore(0)
+    {
+        assign(first, last);
+    }
+
+    CellLoc(std::initializer_list<int> coords) :
+        m_coords(), m_size(0), m_pMore(0)
+    {
+        assign(coords.begin(), coords.end());
+    }
+
+    // Compatibility with the old std::vector<int> CellLoc
+    CellLoc(const std::vector<int>& rCoords);
+    std::vector<int> toVector() const;
+
+    // std::vector style access
+    size_type size() const { return m_size; }
+    bool empty() const { return 0 == m_size; }
+    size_type capacity() const
+    {
+        return m_pMore ? size_type(m_pMore->capacity()) : size_type(MAX_DIMS);
+    }
+    void reserve(size_type numDims)
+    {
+        if (numDims > capacity())
+        {
+            moveToHeap();
+            m_pMore->reserve(numDims);
+        }
+    }
+
+    int& operator[](size_type i) { return data()[i]; }
+    const int& operator[](size_type i) const { return data()[i]; }
+    int& front() { return data()[0]; }
+    const int& front() const { return data()[0]; }
+    int& back() { return data()[m_size-1]; }
+    const int& back() const { return data()[m_size-1]; }
+    int* data() { return m_pMore ? m_pMore->data() : m_coords; }
+    const int* data() const { return m_pMore ? m_pMore->data() : m_coords; }
+
+    iterator begin() { return data(); }
+    iterator end() { return data() + m_size; }
+    const_iterator begin() const { return data(); }
+    const_iterator end() const { return data() + m_size; }
+
+    void push_back(int coord)
+    {
+        if (not m_pMore and (m_size < MAX_DIMS))
+        {
+            m_coords[m_size++] = coord;
+            return;
+        }
+        moveToHeap();
+        m_pMore->push_back(coord);
+        ++m_size;
+    }
+    void pop_back()
+    {
+        if (m_pMore) m_pMore->pop_back();
+        --m_size;
+    }
+    void clear()
+    {
+        if (m_pMore) m_pMore->clear();
+        m_size = 0;
+    }
+    void resize(size_type numDims, int value = 0)
+    {
+        if (m_pMore or (numDims > MAX_DIMS))
+        {
+            moveToHeap();
+            m_pMore->resize(numDims, value);
+            m_size = numDims;
+            return;
+        }
+        while (m_size < numDims) m_coords[m_size++] = value;
+        m_size = numDims;
+    }
+
+    template <class InputItr>
+    void assign(InputItr first, InputItr last)
+    {
+        clear();
+        for ( ; first != last; ++first) push_back(*first);
+    }
+
+    friend bool operator==(const CellLoc& rLHS, const CellLoc& rRHS)
+    {
+        if (rLHS.m_size != rRHS.m_size) return false;
+        const int* l_pLHS = rLHS.data();
+        const int* l_pRHS = rRHS.data();
+        for (size_type i = 0; i < rLHS.m_size; ++i)
+        {
+            if (l_pLHS[i] != l_pRHS[i]) return false;
+        }
+        return true;
+    }
+    friend bool operator!=(const CellLoc& rLHS, const CellLoc& rRHS)
+    {
+        return not (rLHS == rRHS);
+    }
+    // Lexicographic (as std::vector) so can be used as a key
+    friend bool operator<(const CellLoc& rLHS, const CellLoc& rRHS)
+    {
+        return std::lexicographical_compare(rLHS.begin(), rLHS.end(),
+                                            rRHS.begin(), rRHS.end());
+    }
+
+protected:
+    // Put the coordinates in m_pMore (if not already)
+    void moveToHeap();
+    // m_pMore as rOther's for operator=
+    void copyMore(const CellLoc& rOther);
+
+protected:
+    // The coordinates unless m_pMore
+    int               m_coords[MAX_DIMS];
+    size_type         m_size;
+    // All the coordinates once there have been more than MAX_DIMS
+    std::vector<int>* m_pMore;
+};
+
+// Add each coordinate. RHS must have at least as many as LHS
+inline CellLoc& operator+=(CellLoc& rLHS, const CellLoc& rRHS)
+{
+    for (CellLoc::size_type i = 0; i < rLHS.size(); ++i)
+    {
+        rLHS[i] += rRHS[i];
+    }
+    return rLHS;
+}
+
+inline CellLoc operator+(const CellLoc& rLHS, const CellLoc& rRHS)
+{
+    CellLoc l_ret(rLHS);
+    return l_ret += rRHS;
+}
+
+///////////////////////////////////////////////////////////////////////////
+
+template <int N>
+struct CellLocN
+{
+    int m_coords[N];
+
+    static constexpr int size() { return N; }
+
+    constexpr int& operator[](int i) { return m_coords[i]; }
+    constexpr const int& operator[](int i) const { return m_coords[i]; }
+
+    constexpr CellLocN& operator+=(const CellLocN& rRHS)
+    {
+        for (int i = 0; i < N; ++i) m_coords[i] += rRHS.m_coords[i];
+        return *this;
+    }
+    constexpr CellLocN operator+(const CellLocN& rRHS) const
+    {
+        CellLocN l_ret = *this;
+        return l_ret += rRHS;
+    }
+    constexpr CellLocN operator-() const
+    {
+        CellLocN l_ret = *this;
+        for (int i = 0; i < N; ++i) l_ret.m_coords[i] = -l_ret.m_coords[i];
+        return l_ret;
+    }
+    constexpr bool operator==(const CellLocN& rRHS) const
+    {
+        for (int i = 0; i < N; ++i)
+        {
+            if (m_coords[i] != rRHS.m_coords[i]) return false;
+        }
+        return true;
+    }
+    constexpr bool operator!=(const CellLocN& rRHS) const
+    {
+        return not (*this == rRHS);
+    }
+
+    // Index as MazeData::getCellIndex() i.e. first coordinate fastest
+    constexpr int toIndex(const CellLocN& rDimensions) const
+    {
+        int l_index = 0;
+        int l_stride = 1;
+        for (int i = 0; i < N; ++i)
+        {
+            l_index += m_coords[i] * l_stride;
+            l_stride *= rDimensions.m_coords[i];
+        }
+        return l_index;
+    }
+
+    CellLoc toCellLoc() const { return CellLoc(m_coords, m_coords + N); }
+    static CellLocN fromCellLoc(const CellLoc& rLoc)
+    {
+        assert(rLoc.size() == N);
+        CellLocN l_ret = {};
+        for (int i = 0; i < N; ++i) l_ret.m_coords[i] = rLoc[i];
+        return l_ret;
+    }
+};
+
+typedef CellLocN<2> CellLoc2;
+typedef CellLocN<3> CellLoc3;
 
 } // namespace
 
@@ -0,0 +1,107 @@
+#ifndef MAZE_CHUNKED_MAZE_H
+#define MAZE_CHUNKED_MAZE_H
+
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+
+#include "MazeData.h"
+
+//
+// An unbounded 2D square maze made of chunks that are generated when
+// asked for and thrown away when not used for a while, so only the
+// last maxChunks used are in memory however far the player goes.
+//
+// A chunk is a maze the size of the MazeData dimensions (generated by
+// SquareGenerator with the MazeData settings) whose RNG is seeded from
+// (seed, chunk x, chunk y). The edge between two chunks has a door at
+// a position that only depends on (seed, edge), so both chunks agree
+// on it whichever is made first and a chunk is always the same when it
+// is made again. Every chunk is connected inside and has a door on
+// each side, so every cell can reach every other.
+//
+// In a chunk's PackedMaze a door is an open exit off the edge i.e.
+// isOpen() but getExitCell() is -1. It leads to the neighbouring chunk.
+//
+// NOTE: Not thread safe
+//
+namespace RNG { class I_Random; }
+
+namespace Maze {
+
+class PackedMaze;
+class SquareGenerator;
+
+class ChunkedMaze
+{
+public:
+    // rChunkData gives the chunk size (dimensions), where the maze
+    // inside a chunk starts (start loc) and the singlePath, noDeadEnds
+    // and openPlanChance settings. wrapRound is ignored.
+    ChunkedMaze(const MazeData& rChunkData,
+                unsigned int seed,
+                int maxChunks = 64);
+    virtual ~ChunkedMaze();
+
+    int getChunkWidth() const { return m_chunkWidth; }
+    int getChunkHeight() const { return m_chunkHeight; }
+    int getMaxChunks() const { return m_maxChunks; }
+
+    // The chunk, made if it isn't in memory.
+    // NOTE: Only valid until maxChunks other chunks have been asked for
+    virtual const PackedMaze& getChunk(int chunkX, int chunkY);
+
+    // Work out which chunk a cell is in and where in the chunk
+    void getChunkLoc(int x, int y,
+                     int* pChunkX, int* pChunkY,
+                     int* pLocalX, int* pLocalY) const;
+
+    // Is the exit of the cell at x,y open (x,y can be anything)
+    bool isOpen(int x, int y, int exitNum);
+
+    // Where the door on the EAST (or SOUTH) side of a chunk is, as the
+    // y (or x) within the chunk
+    int getDoor(int chunkX, int chunkY, int exitNum) const;
+
+    // Stats
+    int getNumResident() const { return m_chunks.size(); }
+    long getNumGenerated() const { return m_numGenerated; }
+
+protected:
+    struct Chunk {
+        std::uint64_t m_key;
+        PackedMaze*   m_pMaze;
+    };
+    typedef std::list<Chunk> ChunkList;
+
+    static std::uint64_t makeKey(int chunkX, int chunkY)
+    {
+        return (std::uint64_t(std::uint32_t(chunkX)) << 32)
+               | std::uint32_t(chunkY);
+    }
+
+    virtual PackedMaze* makeChunk(int chunkX, int chunkY);
+
+protected:
+    MazeData         m_chunkData;
+    unsigned int     m_seed;
+    int              m_maxChunks;
+    int              m_chunkWidth;
+    int              m_chunkHeight;
+    long             m_numGenerated;
+
+    RNG::I_Random*   m_pRNG;
+    SquareGenerator* m_pGenerator;
+
+    // Most recently used at the front
+    ChunkList        m_chunks;
+    std::unordered_map<std::uint64_t, ChunkList::iterator> m_chunkMap;
+
+private:
+    ChunkedMaze(const ChunkedMaze&);
+    ChunkedMaze& operator=(const ChunkedMaze&);
+};
+
+} // namespace
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef MAZE_CONCURRENT_DISJOINT_SET_H
+#define MAZE_CONCURRENT_DISJOINT_SET_H
+
+#include <atomic>
+#include <utility>
+#include <vector>
+
+//
+// Union-find over the elements 0..N-1 that any number of threads can
+// find() and unite() in at the same time, without locks.
+//
+// An element's entry is its parent, or itself if it is the root of its
+// set. find() uses path halving, each step a compare and swap so a
+// step another thread has already changed is just skipped. unite()
+// links the root with the larger number below the other one with a
+// compare and swap, and starts again if that root got linked first.
+//
+// Which element ends up the representative depends on the order the
+// threads get there, but which unite() calls return true doesn't as
+// long as the edges united between two waits don't make a loop (as in
+// Boruvka's algorithm, see ParallelGenerator::joinTiles).
+//
+namespace Maze {
+
+class ConcurrentDisjointSet
+{
+public:
+    ConcurrentDisjointSet();
+    ~ConcurrentDisjointSet();
+
+    // Make numElements single element sets
+    // NOTE: Not while other threads are using it
+    void reset(int numElements);
+
+    int getNumElements() const { return m_parents.size(); }
+
+    // Return the representative element of the set containing element
+    int find(int element)
+    {
+        for (;;)
+        {
+            int l_parent = m_parents[element].load();
+            if (l_parent == element)
+            {
+                return element;
+            }
+            const int l_grandParent = m_parents[l_parent].load();
+            if (l_grandParent == l_parent)
+            {
+                return l_parent;
+            }
+            m_parents[element].compare_exchange_weak(l_parent, l_grandParent);
+            element = l_grandParent;
+        }
+    }
+
+    // Join the sets containing the two elements.
+    // Returns false if they were already in the same set
+    bool unite(int element1, int element2)
+    {
+        for (;;)
+        {
+            int l_root1 = find(element1);
+            int l_root2 = find(element2);
+            if (l_root1 == l_root2)
+            {
+                return false;
+            }
+            if (l_root1 < l_root2)
+            {
+                std::swap(l_root1, l_root2);
+            }
+            int l_expected = l_root1;
+            if (m_parents[l_root1].compare_exchange_strong(l_expected,
+                                                           l_root2))
+            {
+                return true;
+            }
+        }
+    }
+
+protected:
+    std::vector<std::atomic<int> > m_parents;
+
+private:
+    ConcurrentDisjointSet(const ConcurrentDisjointSet&);
+    ConcurrentDisjointSet& operator=(const ConcurrentDisjointSet&);
+};
+
+} // namespace
+
+#endif
@@ -0,0 +1,116 @@
+#ifndef MAZE_COUNTER_RANDOM_H
+#define MAZE_COUNTER_RANDOM_H
+
+#include <cstdint>
+
+#include "Hash.h"
+
+//
+// Counter based random numbers: the value for (seed, purpose, index) is
+// a hash of them (see Hash.h hashKey), not the next value of a stream.
+// So a draw doesn't depend on how many were made before it, or in what
+// order, or on which thread, and parts of a generation can be split up
+// any way and still give the same maze.
+//
+// It is all 64 bit integer arithmetic (SplitMix64 and a multiply-shift
+// to the range, no floating point or % of the platform's RAND_MAX), so
+// a seed gives the same values with any compiler on any platform.
+//
+// getBlock() works out a run of indexes in one branch free loop the
+// compiler can vectorise; Block keeps the last one for draws that go
+// through the indexes in order (either way).
+//
+// See Generator::setCounterRandom.
+//
+namespace Maze {
+
+class CounterRandom
+{
+public:
+    // What the draws are for, so the same index can be used for each
+    // and get unrelated values
+    enum Purpose {
+        PURPOSE_SHUFFLE = 0,    // Kruskal's shuffle, indexed by position
+        PURPOSE_BACKTRACK,      // backtracker, by how many cells visited
+        PURPOSE_DEAD_END,       // noDeadEnds, by cell index
+        PURPOSE_OPEN_PLAN,      // openPlanChance, by cell*maxExits + exit
+        NUM_PURPOSES
+    };
+
+    enum { BLOCK_SIZE = 64 };
+
+    explicit CounterRandom(unsigned int seed = 1);
+
+    void initialise(unsigned int seed);
+    unsigned int getSeed() const { return m_seed; }
+
+    // 64 random bits for the index (the top 32 are getBits)
+    std::uint64_t getBits64(Purpose purpose, std::uint64_t index) const
+    {
+        // hashKey with the seed and purpose part done
+        return mixHash(m_keys[purpose] ^ index);
+    }
+    std::uint32_t getBits(Purpose purpose, std::uint64_t index) const
+    {
+        return std::uint32_t(getBits64(purpose, index) >> 32);
+    }
+
+    // lo..hi (inclusive) for the index
+    int getIntAt(Purpose purpose, std::uint64_t index, int lo, int hi) const
+    {
+        return toRange(getBits(purpose, index), lo, hi);
+    }
+
+    // getBits of firstIndex..firstIndex+count-1 into pBits
+    void getBlock(Purpose purpose,
+                  std::uint64_t firstIndex,
+                  int count,
+                  std::uint32_t* pBits) const;
+
+    // 32 random bits to lo..hi, without a divide
+    static int toRange(std::uint32_t bits, int lo, int hi)
+    {
+        const std::uint32_t l_range = std::uint32_t(hi - lo) + 1;
+        return lo + int((std::uint64_t(bits) * l_range) >> 32);
+    }
+
+    //
+    // getIntAt from the BLOCK_SIZE indexes around the last one, so
+    // draws for indexes next to each other cost a getBlock between them
+    //
+    class Block
+    {
+    public:
+        Block(const CounterRandom& rRNG, Purpose purpose) :
+            m_rRNG(rRNG), m_purpose(purpose), m_first(~std::uint64_t(0)) { }
+
+        int getIntAt(std::uint64_t index, int lo, int hi)
+        {
+            const std::uint64_t l_first =
+                index & ~std::uint64_t(BLOCK_SIZE - 1);
+            if (l_first != m_first)
+            {
+                m_rRNG.getBlock(m_purpose, l_first, BLOCK_SIZE, m_bits);
+                m_first = l_first;
+            }
+            return toRange(m_bits[index - l_first], lo, hi);
+        }
+
+    private:
+        const CounterRandom& m_rRNG;
+        Purpose              m_purpose;
+        std::uint64_t        m_first;
+        std::uint32_t        m_bits[BLOCK_SIZE];
+
+        Block(const Block&);
+        Block& operator=(const Block&);
+    };
+
+protected:
+    unsigned int  m_seed;
+    std::uint64_t m_keys[NUM_PURPOSES];
+};
+
+} // namespace
+
+#endif
@@ -0,0 +1,103 @@
+#ifndef MAZE_DISJOINT_SET_H
+#define MAZE_DISJOINT_SET_H
+
+#include <vector>
+
+#include "Prefetch.h"
+
+//
+// Union-find over the elements 0..N-1, stored in one contiguous array
+// indexed by element. find() uses path halving and unite() uses union
+// by rank so a sequence of operations runs in near-linear time.
+//
+// An element's entry is its parent, or if it is the root of its set
+// then -1-rank (so a root never needs a second array lookup).
+//
+// reset() keeps the storage so the same object can be reused for
+// each maze generated without allocating again.
+//
+// It counts the finds and unites since the reset (see GenerationStats),
+// just a call each, not the steps inside them.
+//
+namespace Maze {
+
+class DisjointSet
+{
+public:
+    DisjointSet();
+    ~DisjointSet();
+
+    // Make numElements single element sets
+    void reset(int numElements);
+
+    int getNumElements() const { return m_parents.size(); }
+    int getNumSets() const { return m_numSets; }
+    long long getNumFinds() const { return m_numFinds; }
+    long long getNumUnites() const { return m_numUnites; }
+
+    // Return the representative element of the set containing element
+    int find(int element)
+    {
+        ++m_numFinds;
+        while (m_parents[element] >= 0)
+        {
+            const int l_parent = m_parents[element];
+            const int l_grandParent = m_parents[l_parent];
+            if (l_grandParent < 0)
+            {
+                return l_parent;
+            }
+            m_parents[element] = l_grandParent;
+            element = l_grandParent;
+        }
+        return element;
+    }
+
+    bool connected(int element1, int element2)
+    {
+        return find(element1) == find(element2);
+    }
+
+    // Join the sets containing the two elements.
+    // Returns false if they were already in the same set
+    bool unite(int element1, int element2)
+    {
+        ++m_numUnites;
+        int l_root1 = find(element1);
+        int l_root2 = find(element2);
+        if (l_root1 == l_root2)
+        {
+            return false;
+        }
+
+        // Attach the shallower tree below the deeper one
+        // (a larger rank is a more negative entry)
+        if (m_parents[l_root1] > m_parents[l_root2])
+        {
+            m_parents[l_root1] = l_root2;
+        }
+        else
+        {
+            if (m_parents[l_root1] == m_parents[l_root2])
+            {
+                --m_parents[l_root1];
+            }
+            m_parents[l_root2] = l_root1;
+        }
+        --m_numSets;
+        return true;
+    }
+
+    // Warm the cache for an element about to be used
+    void prefetch(int element) const { MAZE_PREFETCH(&m_parents[element]); }
+
+protected:
+    std::vector<int> m_parents;
+    int              m_numSets;
+    long long        m_numFinds;
+    long long        m_numUnites;
+};
+
+} // namespace
+
+#endif
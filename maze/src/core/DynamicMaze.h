@@ -0,0 +1,146 @@
+#ifndef MAZE_DYNAMIC_MAZE_H
+#define MAZE_DYNAMIC_MAZE_H
+
+#include <vector>
+
+#include "MazeData.h"
+#include "PackedMaze.h"
+
+//
+// A generated maze whose exits can be opened and closed afterwards
+// (doors etc.) that keeps which cells can reach each other and the
+// distances from chosen cells up to date as it changes, only looking at
+// the cells the change affects rather than the whole maze.
+//
+// Connectivity: every cell has a component number. Opening an exit
+// between two components renumbers the smaller one. Closing an exit
+// searches from both sides a step at a time each until the searches
+// meet (still connected) or one runs out (it is the part split off, so
+// gets a new number). Either way the cost goes with the smaller side.
+//
+// Distances: addDistanceField() keeps the distance from the nearest of
+// some source cells to every cell. Opening an exit spreads out from it
+// only to the cells that get nearer. Closing one first finds the cells
+// that lost every shortest way back to a source (those only reachable
+// through the cells already found), then works out their new distances
+// from the cells around them.
+//
+// If made from a MazeData the Nodes are kept in step (Node::setOpen),
+// so the MazeData must last as long as the DynamicMaze. Changing the
+// Nodes directly isn't seen, use setOpen() here instead.
+//
+namespace Maze {
+
+class DynamicMaze
+{
+public:
+    enum { UNREACHABLE = -1 };
+
+    explicit DynamicMaze(const PackedMaze& rMaze);
+    explicit DynamicMaze(MazeData& rMazeData);
+    virtual ~DynamicMaze();
+
+    int getNumCells() const { return m_openMasks.size(); }
+    int getCellIndex(const CellLoc& rLoc) const
+    {
+        return m_mazeData.getCellIndex(rLoc);
+    }
+    CellLoc getCellLoc(int cell) const { return m_mazeData.getCellLoc(cell); }
+
+    // Cell the exit leads to or -1 if it leads out of the maze
+    int getExitCell(int cell, int exitNum) const
+    {
+        return m_exitCells[cell * m_maxExits + exitNum];
+    }
+    bool isOpen(int cell, int exitNum) const
+    {
+        return (m_openMasks[cell] >> exitNum) & 1;
+    }
+
+    // Open or close the exit (and the one back). Returns false if it
+    // was already like that or leads nowhere
+    bool setOpen(int cell, int exitNum, bool isOpen);
+
+    // Connectivity
+    int getComponent(int cell) const { return m_components[cell]; }
+    int getComponentSize(int cell) const
+    {
+        return m_componentSizes[m_components[cell]];
+    }
+    bool isConnected(int cellA, int cellB) const
+    {
+        return m_components[cellA] == m_components[cellB];
+    }
+
+    // Distances. Returns the field number
+    int addDistanceField(const std::vector<int>& rSources);
+    int getNumDistanceFields() const { return m_fields.size(); }
+    int getDistance(int field, int cell) const;
+    // Cell next to cell that is a step nearer the sources, -1 if none
+    int getNextCell(int field, int cell) const;
+
+    // Cells looked at by the last setOpen (to see what changes cost)
+    int getLastChangeSize() const { return m_lastChangeSize; }
+
+protected:
+    // Distance stored for cells that can't reach a source
+    enum { FAR_AWAY = 0x3fffffff };
+
+    void startBuild();
+    void finishBuild();
+
+    // Cell an open exit leads to, -1 if closed or it leads out of the
+    // maze (a ChunkedMaze door)
+    int getOpenCell(int cell, int exitNum) const
+    {
+        return isOpen(cell, exitNum) ? getExitCell(cell, exitNum) : -1;
+    }
+
+    // Connectivity
+    void joinComponents(int cellA, int cellB);
+    void splitComponents(int cellA, int cellB);
+    int renumber(int fromCell, int component);
+
+    // Distances
+    void spreadNearer(std::vector<int>& rField, int fromCell, int toCell);
+    void repairFarther(std::vector<int>& rField, int toCell);
+    bool hasNearer(const std::vector<int>& rField,
+                   int cell,
+                   unsigned int mark) const;
+
+    // New mark for the m_marks array
+    unsigned int newMark();
+
+protected:
+    // Only the parameters (not the Nodes)
+    MazeData                          m_mazeData;
+    int                               m_maxExits;
+
+    // Cell each exit leads to (-1 none) as cell * m_maxExits + exitNum
+    std::vector<int>                  m_exitCells;
+    std::vector<PackedMaze::ExitMask> m_openMasks;
+    // Nodes to keep in step (empty if made from a PackedMaze)
+    std::vector<Node*>                m_nodes;
+
+    std::vector<int>                  m_components;
+    std::vector<int>                  m_componentSizes;
+
+    // Per field, the distance of each cell (FAR_AWAY if unreachable)
+    std::vector<std::vector<int> >    m_fields;
+
+    // Scratch
+    std::vector<unsigned int>         m_marks;
+    unsigned int                      m_mark;
+    std::vector<int>                  m_queueA;
+    std::vector<int>                  m_queueB;
+    std::vector<std::pair<int, int> > m_heap;
+    int                               m_lastChangeSize;
+
+private:
+    DynamicMaze(const DynamicMaze&);
+    DynamicMaze& operator=(const DynamicMaze&);
+};
+
+} // namespace
+
+#endif
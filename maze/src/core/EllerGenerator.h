@@ -0,0 +1,86 @@
+#ifndef MAZE_ELLER_GENERATOR_H
+#define MAZE_ELLER_GENERATOR_H
+
+#include <vector>
+
+#include "DisjointSet.h"
+#include "SquareGenerator.h"
+
+//
+// Generates a 2D square maze a row at a time with Eller's algorithm,
+// handing each row to an I_RowSink as soon as it is finished. Only the
+// current row and the next are kept, so the memory used depends on the
+// width and not the height i.e. very tall mazes can be streamed to disk
+// or painted without the whole maze (or any Nodes) being in memory.
+//
+// Each row: cells carried down from the row above keep their set, the
+// others are new sets. Neighbours in different sets are joined at
+// random (on the last row they all are) then every set goes down to the
+// next row from at least one random cell. This makes a perfect maze.
+//
+// noDeadEnds and openPlanChance are done on each row before it is given
+// to the sink, so they can only open exits EAST, WEST or SOUTH (the row
+// above has gone). This means a dead end whose only closed exit is
+// NORTH is left, and open plan has a bit less chance per exit than
+// Generator's.
+//
+// wrapRound and singlePath are ignored (never wraps, the end loc is left
+// as it is). It is NOT the same maze Generator would make for the seed.
+//
+namespace Maze {
+
+class I_RowSink;
+
+class EllerGenerator : public SquareGenerator
+{
+public:
+    EllerGenerator(const MazeData& rMazeData, RNG::I_Random* pRNG);
+
+    virtual ~EllerGenerator();
+
+    // Generate the maze giving each row to the sink in order.
+    // If seed is given the pRNG will be init'ed to it. Once the cancel
+    // flag is set (see SquareGenerator::setCancelFlag) no more rows are
+    // given
+    virtual void generateRows(I_RowSink* pSink, unsigned int seed = 0);
+
+    // Generate the whole maze. The up tree bits are a shortest path tree
+    // from the start (see ParallelGenerator)
+    // NOTE: This is a new PackedMaze which must be deleted by caller
+    //       Returns 0 if the cancel flag was set
+    virtual PackedMaze* generate(unsigned int seed = 0);
+
+    // Bytes of row storage used while generating
+    long getRowBytes() const;
+
+protected:
+    // Put the cells carried down from the row above into their sets
+    void startRow();
+    void joinAcross(bool lastRow);
+    void joinDown();
+    void removeRowDeadEnds(bool lastRow);
+    void makeRowOpenPlan(bool lastRow);
+    // Open an exit of a cell in the current row (SOUTH opens NORTH in
+    // the next row)
+    void openRowExit(int x, int exitNum);
+
+protected:
+    // Open exits of the current row and of the next row (so far)
+    std::vector<PackedMaze::ExitMask> m_rowMasks;
+    std::vector<PackedMaze::ExitMask> m_nextRowMasks;
+
+    // Which cells of the current row are connected
+    DisjointSet      m_rowSets;
+    // Per column: the set the cell was in in the row above (as the
+    // column of that set's root) or -1 if not joined to the row above
+    std::vector<int> m_carriedSets;
+    // Per set label: first column found in it (-1 if none yet)
+    std::vector<int> m_firstInSet;
+    // The columns of the row grouped by set (counting sort on the root)
+    std::vector<int> m_setStarts;
+    std::vector<int> m_setMembers;
+};
+
+} // namespace
+
+#endif
@@ -0,0 +1,173 @@
+#ifndef MAZE_GENERATION_STATS_H
+#define MAZE_GENERATION_STATS_H
+
+#include <chrono>
+#include <iosfwd>
+#include <vector>
+
+//
+// What happened while a maze was generated: how long each phase of
+// Generator::generate took, how much it made and did (see Count), and
+// optionally a trace of timed spans (see Generator::setTracing).
+// Every generated MazeData has one (see MazeData::getStats), so a slow
+// generation can be looked at without turning on the logging.
+//
+// The spans can be written in the Chrome trace event format to load
+// into chrome://tracing or Perfetto (see writeTrace).
+//
+// Building with MAZE_NO_HOT_LOGGING (see Trace.h) leaves the times and
+// counts but never records any spans.
+//
+namespace Maze {
+
+class GenerationStats
+{
+public:
+    enum Phase {
+        PHASE_EXITS = 0,    // making the Nodes and their exits
+        PHASE_MAZE,         // opening exits to make the maze
+        PHASE_DEAD_ENDS,    // noDeadEnds (and the open plan with it)
+        PHASE_OPEN_PLAN,    // openPlanChance (unless fused, see below)
+        PHASE_INDEX,        // counting and indexing the Nodes
+        NUM_PHASES
+    };
+
+    enum Count {
+        COUNT_NODES = 0,    // Nodes made
+        COUNT_EXITS,        // exits of all the Nodes
+        COUNT_OPEN_EXITS,   // of those, open (a passage is two)
+        COUNT_ALLOCATIONS,  // Arena blocks the Nodes went in
+        COUNT_FINDS,        // union-find (DisjointSet) finds
+        COUNT_UNITES,       // union-find unites tried
+        COUNT_UNIONS,       // of those, joining two sets
+        COUNT_DEAD_ENDS,    // Nodes with one open exit
+        COUNT_LOOPS,        // passages more than a tree needs
+        COUNT_PEAK_BYTES,   // most memory the Generator held at once
+        NUM_COUNTS
+    };
+
+    // A timed part of a generation, ms from when the stats were cleared.
+    // depth is how many spans it is inside
+    struct Span {
+        const char* m_pName;
+        double      m_startMs;
+        double      m_ms;
+        int         m_depth;
+    };
+
+    GenerationStats();
+
+    // NOTE: Keeps the tracing on or off
+    void clear();
+
+    double getPhaseMs(Phase phase) const { return m_phaseMs[phase]; }
+    void addPhaseMs(Phase phase, double ms) { m_phaseMs[phase] += ms; }
+    double getTotalMs() const;
+
+    // A phase done in the same loop as another has no time of its own,
+    // it is in the other's e.g. the open plan of a maze too small to
+    // chunk is decided in the dead end sweep (see OpenPlan.h) so its
+    // time is in PHASE_DEAD_ENDS and getPhaseMs gives 0
+    void setPhaseFused(Phase phase) { m_phaseFused[phase] = true; }
+    bool isPhaseFused(Phase phase) const { return m_phaseFused[phase]; }
+
+    long long getCount(Count count) const { return m_counts[count]; }
+    void setCount(Count count, long long value) { m_counts[count] = value; }
+    void addCount(Count count, long long value) { m_counts[count] += value; }
+
+    // e.g. "deadEnds"
+    static const char* getPhaseName(Phase phase);
+    // e.g. "openExits"
+    static const char* getCountName(Count count);
+
+    // Record spans (beginSpan does nothing when off)
+    void setTracing(bool tracing) { m_tracing = tracing; }
+    bool getTracing() const { return m_tracing; }
+
+    // pName must outlive the stats (i.e. a literal). Returns the span
+    // to pass to endSpan, -1 if not tracing (or the library was built
+    // with MAZE_NO_HOT_LOGGING)
+    int beginSpan(const char* pName);
+    void endSpan(int span);
+    const std::vector<Span>& getSpans() const { return m_spans; }
+
+    // The spans as a Chrome trace event JSON array
+    void writeTrace(std::ostream& rStream) const;
+
+    //
+    // Times the phases one after another: each start() ends the phase
+    // before it, stop() ends the last. Each phase is a span too
+    //
+    class PhaseTimer
+    {
+    public:
+        explicit PhaseTimer(GenerationStats& rStats) :
+            m_rStats(rStats), m_phase(NUM_PHASES), m_span(-1) { }
+        ~PhaseTimer() { stop(); }
+
+        void start(Phase phase)
+        {
+            stop();
+            m_phase = phase;
+            m_span = m_rStats.beginSpan(getPhaseName(phase));
+            m_start = Clock::now();
+        }
+        void stop()
+        {
+            if (m_phase != NUM_PHASES)
+            {
+                const std::chrono::duration<double, std::milli> l_ms =
+                    Clock::now() - m_start;
+                m_rStats.addPhaseMs(m_phase, l_ms.count());
+                m_rStats.endSpan(m_span);
+                m_phase = NUM_PHASES;
+                m_span = -1;
+            }
+        }
+
+    private:
+        typedef std::chrono::steady_clock Clock;
+
+        GenerationStats&  m_rStats;
+        Phase             m_phase;
+        int               m_span;
+        Clock::time_point m_start;
+    };
+
+    //
+    // A span for as long as it is in scope. Use MAZE_TRACE_SPAN (see
+    // Trace.h) so it goes with MAZE_NO_HOT_LOGGING
+    //
+    class TraceSpan
+    {
+    public:
+        TraceSpan(GenerationStats& rStats, const char* pName) :
+            m_rStats(rStats), m_span(rStats.beginSpan(pName)) { }
+        ~TraceSpan() { m_rStats.endSpan(m_span); }
+
+    private:
+        GenerationStats& m_rStats;
+        int              m_span;
+
+        TraceSpan(const TraceSpan&);
+        TraceSpan& operator=(const TraceSpan&);
+    };
+
+protected:
+    typedef std::chrono::steady_clock Clock;
+
+    double getMsSinceClear() const;
+
+protected:
+    double            m_phaseMs[NUM_PHASES];
+    bool              m_phaseFused[NUM_PHASES];
+    long long         m_counts[NUM_COUNTS];
+    bool              m_tracing;
+    int               m_depth;
+    std::vector<Span> m_spans;
+    Clock::time_point m_clearTime;
+};
+
+} // namespace
+
+#endif
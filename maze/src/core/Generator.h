@@ -1,6 +1,7 @@
 #ifndef MAZE_GENERATOR_H
 #define MAZE_GENERATOR_H
 
+#include <atomic>
 #include <vector>
 
 #include "MazeData.h"
@@ -39,8 +40,18 @@
 // - openPlanChance = Once all of the above has been done each closed exit
 //               has an "openPlanChance" percent chance of being opened i.e.
 //               setting this to 100 will make every exit open.
+// - algorithm = ALGO_DEFAULT is randomised Kruskal (or the recursive
+//               backtracker if singlePath). ALGO_ELLER is Eller's algorithm
+//               a row at a time (2D square mazes only, see EllerGenerator.h)
+//               The others (Wilson, Prim, growing tree, hunt-and-kill,
+//               Aldous-Broder) work on any TileData, see MazeAlgorithms.h.
+//               singlePath then just picks the furthest cell as the end
 // - pRNG = Use your own RNG instead of the basic default
 //
+// A Generator can only be used by one thread at a time, but separate
+// Generators with separate RNGs can run at the same time. See
+// BatchGenerator for generating lots of mazes across threads.
+//
 // NOTE: No checking it made see if the data is consistent since no assumptions
 // are made about what you are trying to do. E.g. A set of 2D tile data that
 // generates 2 cell types at (row,col) and (row,col+1) would need an even value
@@ -56,6 +67,10 @@ namespace RNG { class I_Random; }
 
 namespace Maze
 {
+class I_RowSink;
+class PackedMaze;
+class ThreadPool;
+
 class Generator
 {
 public:
@@ -63,12 +78,53 @@ public:
 
     virtual ~Generator();
 
+    // If pRNG is 0 then uses its own RNG::RandSimple
     virtual void setRNG(RNG::I_Random* pRNG);
 
+    // Change the parameters of the mazes to generate
+    // (only the parameters are copied, not any Nodes)
+    virtual void setMazeData(const MazeData& rMazeData);
+
+    // Do the open plan of big mazes on the pool (see OpenPlan.h), 0 for
+    // none. The maze is the same either way
+    // NOTE: Not a pool that is running this e.g. a BatchGenerator's
+    virtual void setThreadPool(ThreadPool* pThreadPool);
+
+    // Draw Kruskal's shuffle, the backtracker, noDeadEnds and the open
+    // plan from a CounterRandom keyed by the seed instead of the RNG, so
+    // no draw depends on the ones before it (see CounterRandom.h). Not
+    // the same maze as the RNG gives for the seed. Off by default
+    // NOTE: The other algorithms and Eller's still use the RNG
+    virtual void setCounterRandom(bool counterRandom);
+
+    // Record trace spans of each generate() in the stats of the MazeData
+    // returned (see GenerationStats). Off by default
+    virtual void setTracing(bool tracing);
+
+    // generatePacked returns 0 once *pCancelled is set (0 for never),
+    // which can be from another thread, and generateRows gives no more
+    // rows. 2D square mazes stop part way (see SquareGenerator and
+    // EllerGenerator), others only skip the packing
+    virtual void setCancelFlag(const std::atomic<bool>* pCancelled);
+
     // Generate a maze, if seed is given the pRNG will be init'ed to it
     // NOTE: This is a new MazeData which must be deleted by caller
+    //       (the Nodes are in its Arena and are freed with it)
     virtual MazeData* generate(unsigned int seed = 0);
 
+    // Generate a maze and return it as a PackedMaze (one byte of exit
+    // bits per cell) instead of a graph of Nodes. 2D square mazes are
+    // generated by SquareGenerator (same maze, much faster)
+    // NOTE: This is a new PackedMaze which must be deleted by caller
+    //       Returns 0 if cancelled (see setCancelFlag)
+    virtual PackedMaze* generatePacked(unsigned int seed = 0);
+
+    // Generate a maze giving it to the sink a row at a time. With
+    // ALGO_ELLER the whole maze is never in memory, otherwise it is
+    // generated packed and then handed over row by row (none if
+    // cancelled, see setCancelFlag)
+    virtual void generateRows(I_RowSink* pSink, unsigned int seed = 0);
+
 protected:
     class Impl;
     Impl* pimpl;
@@ -0,0 +1,43 @@
+#ifndef MAZE_HASH_H
+#define MAZE_HASH_H
+
+#include <cstdint>
+
+//
+// Cheap well mixed hashes for turning (seed, index) into independent
+// looking numbers e.g. to seed an RNG per tile or pick a random weight
+// for an edge, without the result depending on the order things are
+// done in.
+//
+namespace Maze {
+
+// SplitMix64 finaliser. Every bit of value affects every bit of result
+inline std::uint64_t mixHash(std::uint64_t value)
+{
+    value += 0x9E3779B97F4A7C15ULL;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+    return value ^ (value >> 31);
+}
+
+// Hash of a seed, an index and what it is for (so the same index can
+// be used for different things and get unrelated values)
+inline std::uint64_t hashKey(std::uint64_t seed,
+                             std::uint64_t index,
+                             std::uint64_t purpose)
+{
+    return mixHash(mixHash(seed ^ (purpose << 56)) ^ index);
+}
+
+// As hashKey but as a (non zero) seed for an RNG
+inline unsigned int hashSeed(std::uint64_t seed,
+                             std::uint64_t index,
+                             std::uint64_t purpose)
+{
+    unsigned int l_seed = hashKey(seed, index, purpose) >> 32;
+    return l_seed ? l_seed : 1;
+}
+
+} // namespace
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef MAZE_I_MAZE_ALGORITHM_H
+#define MAZE_I_MAZE_ALGORITHM_H
+
+//
+// A way of making a perfect maze on a CellGraph i.e. opening exits so
+// every cell can be reached from every other by exactly one path.
+// Generator uses one for each MazeData::Algorithm (see MazeAlgorithms.h)
+//
+// All the random choices come from the RNG given, so the same seed
+// gives the same maze.
+//
+namespace RNG { class I_Random; }
+
+namespace Maze {
+
+class CellGraph;
+
+class I_MazeAlgorithm
+{
+public:
+    virtual ~I_MazeAlgorithm() { }
+
+    // Open exits in the graph to make a maze. The graph has no cells in
+    // the maze and no exits open. startCell is the cell to start from
+    virtual void makeMaze(CellGraph& rGraph,
+                          int startCell,
+                          RNG::I_Random& rRNG) = 0;
+};
+
+} // namespace
+
+#endif
@@ -0,0 +1,28 @@
+#ifndef MAZE_I_ROW_SINK_H
+#define MAZE_I_ROW_SINK_H
+
+#include "PackedMaze.h"
+
+//
+// Something that takes a maze a row at a time as it is generated e.g.
+// to write it to a file or paint it, without the whole maze ever being
+// in memory. See Generator::generateRows and EllerGenerator.
+//
+namespace Maze {
+
+class I_RowSink
+{
+public:
+    virtual ~I_RowSink() { }
+
+    // Called for each row in order (y = 0, 1, ...) once it is finished.
+    // pOpenMasks are the open exit bits of the width cells of the row
+    // (as PackedMaze::getOpenMask) and are only valid during the call
+    virtual void addRow(int y,
+                        const PackedMaze::ExitMask* pOpenMasks,
+                        int width) = 0;
+};
+
+} // namespace
+
+#endif
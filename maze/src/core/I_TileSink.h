@@ -0,0 +1,24 @@
+#ifndef MAZE_I_TILE_SINK_H
+#define MAZE_I_TILE_SINK_H
+
+//
+// Something that takes the tiles of a rasterized maze a row at a time
+// e.g. to put them in a tile map, draw them or print them, without
+// needing the whole grid in memory first. See Rasterizer.
+//
+namespace Maze {
+
+class I_TileSink
+{
+public:
+    virtual ~I_TileSink() { }
+
+    // Called for each row in order (y = 0, 1, ...). pTiles are the width
+    // Rasterizer::Tile values of the row and are only valid during the
+    // call. Rows that are the same are often passed the same pTiles
+    virtual void addRow(int y, const unsigned char* pTiles, int width) = 0;
+};
+
+} // namespace
+
+#endif
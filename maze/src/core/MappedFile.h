@@ -0,0 +1,42 @@
+#ifndef MAZE_MAPPED_FILE_H
+#define MAZE_MAPPED_FILE_H
+
+#include <string>
+
+//
+// A file mapped read only into memory (mmap, or a file mapping on
+// Windows). The pages are only read from the file when first looked at,
+// so opening even a huge file is instant. Unmapped when deleted.
+//
+namespace Maze {
+
+class MappedFile
+{
+public:
+    MappedFile();
+    virtual ~MappedFile();
+
+    // Returns false (and logs why) if the file can't be mapped
+    bool open(const std::string& rPath);
+    void close();
+
+    bool isOpen() const { return 0 != m_pData; }
+    const unsigned char* getData() const { return m_pData; }
+    long long getSize() const { return m_size; }
+
+protected:
+    const unsigned char* m_pData;
+    long long            m_size;
+#ifdef _WIN32
+    void*                m_hFile;
+    void*                m_hMapping;
+#endif
+
+private:
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+};
+
+} // namespace
+
+#endif
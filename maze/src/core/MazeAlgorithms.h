@@ -0,0 +1,115 @@
+#ifndef MAZE_MAZE_ALGORITHMS_H
+#define MAZE_MAZE_ALGORITHMS_H
+
+#include <vector>
+
+#include "I_MazeAlgorithm.h"
+#include "MazeData.h"
+
+//
+// The maze algorithms that work on any TileData (via CellGraph). They
+// all make perfect mazes but with a different look:
+//
+// - Wilson       Loop erased random walks. An unbiased maze (every
+//                possible maze is as likely). Slow to start on big
+//                mazes as the first walks have to find the maze
+// - Prim         Grows out from the start by joining a random cell
+//                next to the maze. Lots of short dead ends, very
+//                branchy
+// - GrowingTree  Keeps a list of cells to grow from, taking the newest
+//                (long winding passages like the backtracker) or a
+//                random one (like Prim) with the chance given
+// - HuntAndKill  Random walk until stuck, then scans for a cell next to
+//                the maze and carries on from there. Long passages,
+//                few dead ends
+// - AldousBroder Random walk that opens an exit whenever it enters a
+//                new cell. Unbiased like Wilson but very slow to finish
+//
+// AldousBroder assumes every cell can be reached from the start (as
+// the recursive backtracker does). Wilson leaves out the cells that
+// can't, and with one way Connections those that can't get back to it.
+//
+namespace Maze {
+
+class CellGraph;
+
+// NOTE: This is a new I_MazeAlgorithm which must be deleted by caller.
+// Returns 0 for ALGO_DEFAULT and ALGO_ELLER (done by Generator itself)
+I_MazeAlgorithm* makeMazeAlgorithm(MazeData::Algorithm algorithm);
+
+////
+
+class WilsonAlgorithm : public I_MazeAlgorithm
+{
+public:
+    virtual void makeMaze(CellGraph& rGraph,
+                          int startCell,
+                          RNG::I_Random& rRNG);
+
+protected:
+    // Per cell: exit the last walk left it by
+    std::vector<unsigned short> m_walkExits;
+    // Per cell: can be walked from (see findWalkCells)
+    std::vector<bool>           m_walkCells;
+};
+
+////
+
+class PrimAlgorithm : public I_MazeAlgorithm
+{
+public:
+    virtual void makeMaze(CellGraph& rGraph,
+                          int startCell,
+                          RNG::I_Random& rRNG);
+
+protected:
+    void addFrontier(CellGraph& rGraph, int cell);
+
+protected:
+    // Cells not in the maze that are next to it
+    std::vector<int>  m_frontier;
+    std::vector<char> m_inFrontier;
+};
+
+////
+
+class GrowingTreeAlgorithm : public I_MazeAlgorithm
+{
+public:
+    // newestChance = percent chance of growing from the newest cell,
+    // otherwise from a random one
+    explicit GrowingTreeAlgorithm(int newestChance = 75);
+
+    virtual void makeMaze(CellGraph& rGraph,
+                          int startCell,
+                          RNG::I_Random& rRNG);
+
+protected:
+    int              m_newestChance;
+    // Cells that might still have neighbours not in the maze
+    std::vector<int> m_activeCells;
+};
+
+////
+
+class HuntAndKillAlgorithm : public I_MazeAlgorithm
+{
+public:
+    virtual void makeMaze(CellGraph& rGraph,
+                          int startCell,
+                          RNG::I_Random& rRNG);
+};
+
+////
+
+class AldousBroderAlgorithm : public I_MazeAlgorithm
+{
+public:
+    virtual void makeMaze(CellGraph& rGraph,
+                          int startCell,
+                          RNG::I_Random& rRNG);
+};
+
+} // namespace
+
+#endif
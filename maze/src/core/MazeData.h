@@ -1,20 +1,49 @@
 #ifndef MAZE_MAZEDATA_H
 #define MAZE_MAZEDATA_H
 
+#include <vector>
+
+#include "Arena.h"
 #include "CellLoc.h"
 #include "CellType.h"
+#include "GenerationStats.h"
 #include "TileData.h"
 
 //
 // Used to pass all the info needed to create a maze to Generator
 // which then populates the Root Node i.e. the actual maze
 //
+// The MazeData owns the Nodes under the root. Generator allocates them
+// (and their exits) from the MazeData's Arena so they are all freed at
+// once with it. Nodes made by hand with new are deleted one by one (see
+// MazeHelper::deleteMaze) unless the Arena has been used.
+//
+// Copying a MazeData only copies the parameters, not the Nodes (or the
+// GenerationStats of making them).
+//
+// The dimensions, locations and Connections can have any number of
+// coordinates, but only up to CellLoc::MAX_DIMS (4) are kept inline (see
+// CellLoc.h) or can be stored in a MazeFile.
+//
 namespace Maze {
     class Node;
 
 class MazeData
 {
 public:
+    // How the maze is made (see Generator.h)
+    enum Algorithm {
+        ALGO_DEFAULT = 0,   // Kruskal, or recursive backtracker if singlePath
+        ALGO_ELLER,         // Eller's, a row at a time (see EllerGenerator.h)
+        // See MazeAlgorithms.h
+        ALGO_WILSON,
+        ALGO_PRIM,
+        ALGO_GROWING_TREE,
+        ALGO_HUNT_AND_KILL,
+        ALGO_ALDOUS_BRODER,
+        NUM_ALGORITHMS
+    };
+
     MazeData();
 
     MazeData(const TileData& rTileData,
@@ -25,6 +54,10 @@ public:
              bool noDeadEnds=false,
              int openPlanChance=0);
 
+    // Copies the parameters only (the copy has no root)
+    MazeData(const MazeData& rOther);
+    MazeData& operator=(const MazeData& rOther);
+
     virtual ~MazeData();
 
     // Accessors
@@ -35,6 +68,7 @@ public:
     virtual bool getSinglePath() const { return m_singlePath; }
     virtual bool getNoDeadEnds() const { return m_noDeadEnds; }
     virtual int  getOpenPlanChance() const { return m_openPlanChance; }
+    virtual Algorithm getAlgorithm() const { return m_algorithm; }
 
     // Settors
     virtual void setTileData(const TileData& rTileData);
@@ -44,19 +78,64 @@ public:
     virtual void setSinglePath(bool singlePath);
     virtual void setNoDeadEnds(bool noDeadEnds);
     virtual void setOpenPlanChance(int openPlanChance);
+    virtual void setAlgorithm(Algorithm algorithm);
 
     virtual Node* getRoot() const { return m_pRoot; }
-    virtual void setRoot(Node* pRoot) { m_pRoot = pRoot; }
+
+    // Where the Nodes of this maze are allocated
+    virtual Arena& getArena() { return m_arena; }
+    virtual const Arena& getArena() const { return m_arena; }
+
+    // NOTE: Clears the node index (see buildNodeIndex)
+    virtual void setRoot(Node* pRoot);
+
+    // Find the Node at a location in constant time.
+    // Returns 0 if outside the dimensions or the index hasn't been built
+    virtual Node* getNodeAt(const CellLoc& rLoc) const;
+    virtual Node* getNodeAt(int x, int y) const;
+
+    // Index every Node under the root by its cell index.
+    // Generator does this once the maze is generated, only need to call
+    // it if building the Nodes by hand
+    // NOTE: setDimensions clears it too
+    virtual void buildNodeIndex();
+
+    // Take an index already built (one Node* per cell index, e.g.
+    // Generator's node store) instead of building it. Swaps with
+    // rNodeIndex, which is left empty
+    virtual void setNodeIndex(std::vector<Node*>& rNodeIndex);
 
     // End loc only really makes sense for single path maze
     virtual void setEndLoc(const CellLoc& endLoc) { m_endLoc = endLoc; }
     virtual const CellLoc& getEndLoc() const { return m_endLoc; }
 
+    // How the generation went (see GenerationStats.h)
+    virtual const GenerationStats& getStats() const { return m_stats; }
+    virtual GenerationStats& getStats() { return m_stats; }
+
     // Helper
     virtual int getTotalCells() const;
 
+    // Convert a location inside the dimensions to an index in the
+    // range 0..getTotalCells()-1. The first coordinate changes fastest
+    virtual int getCellIndex(const CellLoc& rLoc) const;
+
+    // Convert an index back to a location
+    virtual CellLoc getCellLoc(int index) const;
+
+    // Check that the location is within the dimensions. If not then
+    // wrap it so it is (if wrapRound is on) otherwise return false
+    virtual bool validLocation(CellLoc* pLoc) const;
+
+protected:
+    void copyParameters(const MazeData& rOther);
+    void deleteNodes();
+
 protected:
     Node*    m_pRoot;
+    Arena    m_arena;
+    std::vector<Node*> m_nodeIndex;
+    GenerationStats m_stats;
 
     TileData m_tileData;
     CellLoc  m_dimensions;
@@ -67,6 +146,7 @@ protected:
     bool     m_singlePath;
     bool     m_noDeadEnds;
     int      m_openPlanChance;
+    Algorithm m_algorithm;
 };
 
 } // namespace
@@ -0,0 +1,64 @@
+#ifndef MAZE_MAZE_FILE_H
+#define MAZE_MAZE_FILE_H
+
+#include <string>
+
+//
+// Saves a generated maze to a file and loads it again, instead of
+// generating it again from the seed (slow for big mazes, and gives a
+// different maze if the RNG ever changes).
+//
+// The file is a header with the MazeData (TileData Connections,
+// dimensions, start and end, flags) then the PackedMaze arrays as they
+// are in memory, each starting on a new page:
+//
+//   "MAZE" u32 version u32 headerBytes
+//   u32 flags (1 wrapRound, 2 singlePath, 4 noDeadEnds, 8 has endLoc)
+//   i32 openPlanChance i32 algorithm
+//   u32 numDims i32 dimensions[4] i32 startLoc[4] i32 endLoc[4]
+//   u32 firstCellType
+//   u32 numConnections { u32 from u32 to i32 locChange[4] }
+//   u32 numCellTypes { u32 cellType }
+//   u64 numCells u64 openMasksAt u64 upTreeMasksAt u64 typeIdxsAt (or 0)
+//   ... open masks, up tree masks, type indices (a byte per cell each)
+//
+// Numbers are little endian whatever the machine. The version goes up
+// if the layout changes, and read() refuses versions it doesn't know.
+//
+// read() maps the file into memory and returns a PackedMaze that is a
+// view of the mapped arrays, so nothing is read in or converted: the
+// pages are only loaded from disk as cells are looked at. A file of a
+// 100M cell maze opens as fast as a small one. So read() checks the
+// header (that the arrays are in the file, the algorithm is one there
+// is, the start, end and Connection changes fit the dimensions, and no
+// cell type has more than PackedMaze::MAX_EXITS Connections) but
+// not what is in the arrays: a damaged mask just gives a different
+// maze, and a damaged cell type index is taken as the first type (see
+// PackedMaze::getTypeIdx).
+//
+namespace Maze {
+
+class MazeData;
+class PackedMaze;
+
+class MazeFile
+{
+public:
+    enum { VERSION = 1 };
+
+    // Returns false (and logs why) if the file can't be written (or the
+    // maze has more than CellLoc::MAX_DIMS dimensions, or a cell type
+    // with more than PackedMaze::MAX_EXITS Connections)
+    static bool write(const PackedMaze& rMaze, const std::string& rPath);
+    // Packs the generated Nodes first
+    static bool write(const MazeData& rMazeData, const std::string& rPath);
+
+    // NOTE: This is a new PackedMaze which must be deleted by caller
+    // (which unmaps the file). Returns 0 (and logs why) if the file
+    // can't be read or isn't a maze file this version understands
+    static PackedMaze* read(const std::string& rPath);
+};
+
+} // namespace
+
+#endif
@@ -12,6 +12,8 @@
 // Helper functions
 //
 
+#include <atomic>
+
 #include "CellLoc.h"
 #include "CellType.h"
 #include "TileData.h"
@@ -19,6 +21,7 @@
 namespace Maze {
 class Node;
 class MazeData;
+class PackedMaze;
 } // namespace Maze
 
 namespace Maze {
@@ -34,7 +37,9 @@ public:
   static void makeNodeList(Node *pRoot, NodeList &rNodeList);
 
   //
-  // Helper function to delete all the Nodes
+  // Helper function to delete all the Nodes, for a maze of Nodes made
+  // by hand with new. Generated Nodes are in their MazeData's Arena and
+  // are freed with the MazeData, so this does nothing for them
   //
   static void deleteMaze(Node *pRoot);
 
@@ -45,14 +50,23 @@ public:
                                  const CellType roomType = 0);
 
   //
-  // Find node with given CellLoc (not efficient!)
+  // Find node with given CellLoc or coordinates (x,y) in a generated maze
+  // Constant time, see MazeData::getNodeAt
   //
-  static const Maze::Node *findNode(const Maze::Node *pRoot,
+  static const Maze::Node *findNode(const Maze::MazeData &rMaze,
                                     const Maze::CellLoc &loc);
+  static const Maze::Node *findNode(const Maze::MazeData &rMaze, int x,
+                                    int y);
 
   //
-  // Find node with given coordinates (x,y)
+  // DEPRECATED: Find node with given CellLoc or coordinates (x,y) by
+  // searching from pRoot (not efficient!). Use the MazeData versions
+  // above, this is only for Nodes not in a MazeData
   //
+  [[deprecated("use findNode(const MazeData&, ...)")]]
+  static const Maze::Node *findNode(const Maze::Node *pRoot,
+                                    const Maze::CellLoc &loc);
+  [[deprecated("use findNode(const MazeData&, ...)")]]
   static const Maze::Node *findNode(const Maze::Node *pRoot, int x, int y);
 
   //
@@ -62,6 +76,17 @@ public:
                                       int startY, bool wrap, bool singlePath,
                                       bool noDeadEnds, int openPlanChance,
                                       unsigned int seed);
+
+  //
+  // Generate a square maze as a PackedMaze. Returns 0 if *pCancelled
+  // is set (from another thread) before it is done, see
+  // Generator::setCancelFlag
+  //
+  static PackedMaze *
+  generateSquarePackedMaze(int width, int height, int startX, int startY,
+                           bool wrap, bool singlePath, bool noDeadEnds,
+                           int openPlanChance, unsigned int seed,
+                           const std::atomic<bool> *pCancelled = 0);
 };
 
 } // namespace Maze
@@ -3,8 +3,6 @@
 
 #include <iostream>
 
-#include <vector>
-
 #include "CellLoc.h"
 #include "CellType.h"
 
@@ -50,13 +48,30 @@ public:
             m_pNode(pNode), m_flags(flags) { }
     };
 
+    // Node that stores its exits in pExitStore (room for maxExits)
+    // instead of allocating them. The Node doesn't own pExitStore.
+    // Generator uses this to put the Node and its exits in an Arena
+    Node(const CellType& rType, const CellLoc& rLoc,
+         Exit* pExitStore, int maxExits);
+
     void addExit(const Exit& rExit);
     void setOpen(int exitNum, bool isOpen);
 
+    // True if made with an exit store i.e. by Generator, in an Arena
+    bool hasExitStore() const { return not m_ownExits; }
+
 protected:
     CellType           m_type;
     CellLoc            m_location;
-    std::vector<Exit>  m_exits;
+    Exit*              m_pExits;
+    unsigned short     m_numExits;
+    unsigned short     m_maxExits;
+    bool               m_ownExits;
+
+private:
+    // Would need to copy the exits
+    Node(const Node&);
+    Node& operator=(const Node&);
 };
 
 // For Debug
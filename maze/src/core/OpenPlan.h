@@ -0,0 +1,127 @@
+#ifndef MAZE_OPEN_PLAN_H
+#define MAZE_OPEN_PLAN_H
+
+#include <cstdint>
+
+#include "CounterRandom.h"
+#include "Hash.h"
+
+//
+// How Generator and SquareGenerator remove dead ends and make the maze
+// open plan, shared so the two still make the same maze.
+//
+// Both are done in one sweep through the cells in the order the Nodes
+// were created. A dead end (one open exit) gets a random closed exit
+// opened as soon as it is reached, as before. openPlanChance used to
+// give each closed exit that chance in a second sweep, so a passage
+// closed after the dead ends got two tries, one from each of its cells.
+// Now the passage is decided in one go, with the same two tries, when
+// the sweep reaches the second of its cells (so both have had their
+// dead end check and it can't change one).
+//
+// Mazes of MIN_CHUNKED_CELLS or more do the open plan after the dead
+// ends, in chunks of CHUNK_CELLS cells of the sweep. Each chunk has its
+// own RNG seeded from one draw of the maze's RNG, and opens passages
+// into earlier chunks afterwards, so the chunks can go on a ThreadPool
+// and the maze is the same on any number of threads.
+//
+// With a CounterRandom (see Generator::setCounterRandom) the tries for a
+// passage are keyed by the passage, so chunked or not it is the same
+// maze, and the same as for any other chunk size.
+//
+namespace Maze {
+namespace OpenPlan {
+
+enum {
+    DRAW_BATCH = 64,
+    CHUNK_CELLS = 16 * 1024,
+    MIN_CHUNKED_CELLS = 4 * CHUNK_CELLS
+};
+
+// For hashSeed
+enum { HASH_CHUNK = 1 };
+
+inline bool useChunks(int numCells, int openPlanChance)
+{
+    return openPlanChance and (numCells >= MIN_CHUNKED_CELLS);
+}
+
+inline int getNumChunks(int numCells)
+{
+    return (numCells + CHUNK_CELLS - 1) / CHUNK_CELLS;
+}
+
+//
+// The passage draws (0..99), made DRAW_BATCH at a time in a tight loop
+// rather than one call in the middle of each cell's exits
+//
+template <typename T_RNG>
+class PassageDraws
+{
+public:
+    PassageDraws(T_RNG& rRNG, int openPlanChance) :
+        m_rRNG(rRNG),
+        m_chance(openPlanChance),
+        m_next(DRAW_BATCH)
+    {
+    }
+
+    // True if the next passage is to be opened (one try from each of
+    // its cells). The passage is only for KeyedPassageDraws
+    bool openNext(std::uint64_t)
+    {
+        return (nextDraw() < m_chance) or (nextDraw() < m_chance);
+    }
+
+private:
+    int nextDraw()
+    {
+        if (DRAW_BATCH == m_next)
+        {
+            for (int i = 0; i < DRAW_BATCH; ++i)
+            {
+                m_draws[i] = m_rRNG.getInt(0, 99);
+            }
+            m_next = 0;
+        }
+        return m_draws[m_next++];
+    }
+
+    T_RNG& m_rRNG;
+    int    m_chance;
+    int    m_next;
+    int    m_draws[DRAW_BATCH];
+};
+
+//
+// As PassageDraws but the two tries for a passage come from the two
+// halves of the CounterRandom bits for it (cell*maxExits + exit of its
+// later cell), so passages can be decided in any order
+//
+class KeyedPassageDraws
+{
+public:
+    KeyedPassageDraws(const CounterRandom& rRNG, int openPlanChance) :
+        m_rRNG(rRNG),
+        m_chance(openPlanChance)
+    {
+    }
+
+    bool openNext(std::uint64_t passage) const
+    {
+        const std::uint64_t l_bits =
+            m_rRNG.getBits64(CounterRandom::PURPOSE_OPEN_PLAN, passage);
+        return (CounterRandom::toRange(l_bits >> 32, 0, 99) < m_chance)
+            or (CounterRandom::toRange(std::uint32_t(l_bits), 0, 99)
+                < m_chance);
+    }
+
+private:
+    const CounterRandom& m_rRNG;
+    int                  m_chance;
+};
+
+} // namespace OpenPlan
+} // namespace Maze
+
+#endif
@@ -0,0 +1,199 @@
+#ifndef MAZE_PACKED_MAZE_H
+#define MAZE_PACKED_MAZE_H
+
+#include <vector>
+
+#include "CellLoc.h"
+#include "CellType.h"
+#include "MazeData.h"
+
+//
+// A compact read-only copy of a generated maze.
+//
+// Instead of a graph of heap allocated Nodes each cell is stored as a
+// byte of OPEN exit bits, a byte of UPTREE exit bits and a byte giving
+// its cell type. Each is held in its own array (struct-of-arrays)
+// addressed by the cell index from MazeData::getCellIndex() i.e. for
+// a 2D maze index = y*width + x, so scanning the arrays in order
+// visits the maze row by row.
+//
+// Exit n of a cell is bit n of its masks, so a cell type can have at
+// most MAX_EXITS connections.
+//
+// Cell gives the same read-only accessors as Node for a single cell.
+//
+// The arrays don't have to belong to the PackedMaze, it can be a view of
+// arrays kept somewhere else e.g. a memory mapped file (see MazeFile.h),
+// so a maze can be used without copying it in.
+//
+namespace Maze {
+
+class MappedFile;
+
+class PackedMaze
+{
+public:
+    enum { MAX_EXITS = 8 };
+    typedef unsigned char ExitMask;
+
+    class Cell;
+
+    // Pack the maze generated into rMazeData (from its root Node)
+    PackedMaze(const MazeData& rMazeData);
+
+    // Take over cells that are already packed (the vectors are swapped
+    // out) for a maze whose TileData only has the first cell type
+    PackedMaze(const MazeData& rMazeData,
+               std::vector<ExitMask>& rOpenMasks,
+               std::vector<ExitMask>& rUpTreeMasks);
+
+    // View of arrays kept elsewhere (getTotalCells() of each). If
+    // pTypeIdxs is 0 every cell is the first cell type in rCellTypes.
+    // NOTE: pStorage (if not 0) is deleted with the PackedMaze, it
+    // should be what holds the arrays
+    PackedMaze(const MazeData& rMazeData,
+               const ExitMask* pOpenMasks,
+               const ExitMask* pUpTreeMasks,
+               const unsigned char* pTypeIdxs,
+               const std::vector<CellType>& rCellTypes,
+               MappedFile* pStorage);
+    virtual ~PackedMaze();
+
+    // The parameters the maze was generated with
+    const MazeData& getMazeData() const { return m_mazeData; }
+    const TileData& getTileData() const { return m_mazeData.getTileData(); }
+    const CellLoc& getDimensions() const { return m_mazeData.getDimensions(); }
+    const CellLoc& getStartLoc() const { return m_mazeData.getStartLoc(); }
+    const CellLoc& getEndLoc() const { return m_mazeData.getEndLoc(); }
+
+    int getNumCells() const { return m_numCells; }
+    int getCellIndex(const CellLoc& rLoc) const
+    {
+        return m_mazeData.getCellIndex(rLoc);
+    }
+    CellLoc getCellLoc(int cell) const { return m_mazeData.getCellLoc(cell); }
+
+    // Per cell accessors (cell = index 0..getNumCells()-1)
+    const CellType& getCellType(int cell) const
+    {
+        return m_cellTypes[getTypeIdx(cell)];
+    }
+    int getNumExits(int cell) const { return m_numExits[getTypeIdx(cell)]; }
+    ExitMask getOpenMask(int cell) const { return m_pOpenMasks[cell]; }
+    ExitMask getUpTreeMask(int cell) const { return m_pUpTreeMasks[cell]; }
+
+    // Index of the cell's type in getCellTypes(). One that isn't (only
+    // from a damaged MazeFile) is taken as 0
+    int getTypeIdx(int cell) const
+    {
+        const unsigned int l_idx = m_pTypeIdxs ? m_pTypeIdxs[cell] : 0;
+        return (l_idx < m_cellTypes.size()) ? l_idx : 0;
+    }
+    const std::vector<CellType>& getCellTypes() const { return m_cellTypes; }
+
+    bool isOpen(int cell, int exitNum) const
+    {
+        return (m_pOpenMasks[cell] >> exitNum) & 1;
+    }
+    bool isClosed(int cell, int exitNum) const
+    {
+        return not isOpen(cell, exitNum);
+    }
+    bool isUpTree(int cell, int exitNum) const
+    {
+        return (m_pUpTreeMasks[cell] >> exitNum) & 1;
+    }
+    bool isDownTree(int cell, int exitNum) const
+    {
+        return not isUpTree(cell, exitNum);
+    }
+
+    // Index of the cell the exit leads to or -1 if it leads out of the maze
+    int getExitCell(int cell, int exitNum) const;
+
+    // The whole arrays, for sequential scans
+    const ExitMask* getOpenMasks() const { return m_pOpenMasks; }
+    const ExitMask* getUpTreeMasks() const { return m_pUpTreeMasks; }
+    // 0 if every cell is the first type
+    const unsigned char* getTypeIdxs() const { return m_pTypeIdxs; }
+
+    Cell getCell(int cell) const;
+    Cell getCell(const CellLoc& rLoc) const;
+
+    // Bytes used by the packed cells (including those kept elsewhere)
+    long getMemoryUsed() const;
+
+protected:
+    // Point at the vectors below
+    void useOwnArrays();
+
+protected:
+    MazeData              m_mazeData;
+    int                   m_numCells;
+
+    // Where the arrays are, either the vectors or elsewhere
+    const ExitMask*       m_pOpenMasks;
+    const ExitMask*       m_pUpTreeMasks;
+    const unsigned char*  m_pTypeIdxs;
+    MappedFile*           m_pStorage;
+
+    std::vector<ExitMask> m_openMasks;
+    std::vector<ExitMask> m_upTreeMasks;
+    std::vector<unsigned char> m_typeIdxs;
+
+    // Indexed by the values in m_typeIdxs
+    std::vector<CellType> m_cellTypes;
+    std::vector<int>      m_numExits;
+
+private:
+    // Might not own the arrays
+    PackedMaze(const PackedMaze&);
+    PackedMaze& operator=(const PackedMaze&);
+};
+
+///////////////////////////////////////////////////////////////////////////
+
+//
+// Node style view of one cell of a PackedMaze. Cheap to copy.
+//
+class PackedMaze::Cell
+{
+public:
+    Cell(const PackedMaze* pMaze=0, int index=-1) :
+        m_pMaze(pMaze), m_index(index) { }
+
+    // False for the Cell returned by an exit that leads out of the maze
+    bool isValid() const { return m_index >= 0; }
+    int  getIndex() const { return m_index; }
+
+    const CellType& getCellType() const { return m_pMaze->getCellType(m_index); }
+    CellLoc getCellLoc() const { return m_pMaze->getCellLoc(m_index); }
+
+    int  getNumExits() const { return m_pMaze->getNumExits(m_index); }
+    bool isOpen(int exitNum) const { return m_pMaze->isOpen(m_index, exitNum); }
+    bool isClosed(int exitNum) const { return m_pMaze->isClosed(m_index, exitNum); }
+    bool isUpTree(int exitNum) const { return m_pMaze->isUpTree(m_index, exitNum); }
+    bool isDownTree(int exitNum) const { return m_pMaze->isDownTree(m_index, exitNum); }
+    Cell getExitNode(int exitNum) const
+    {
+        return Cell(m_pMaze, m_pMaze->getExitCell(m_index, exitNum));
+    }
+
+protected:
+    const PackedMaze* m_pMaze;
+    int               m_index;
+};
+
+inline PackedMaze::Cell PackedMaze::getCell(int cell) const
+{
+    return Cell(this, cell);
+}
+
+inline PackedMaze::Cell PackedMaze::getCell(const CellLoc& rLoc) const
+{
+    return Cell(this, getCellIndex(rLoc));
+}
+
+} // namespace
+
+#endif
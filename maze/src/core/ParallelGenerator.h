@@ -0,0 +1,127 @@
+#ifndef MAZE_PARALLEL_GENERATOR_H
+#define MAZE_PARALLEL_GENERATOR_H
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "ConcurrentDisjointSet.h"
+#include "SquareGenerator.h"
+
+//
+// Generates one big 2D square maze using all the cores.
+//
+// The grid is split into tiles (tileSize x tileSize) and each tile is
+// made into a maze on its own by SquareGenerator (so Kruskal, or the
+// recursive backtracker if singlePath) on a ThreadPool. The tiles are
+// then joined by opening one exit on the seams between them, chosen as
+// the minimum spanning tree of the tiles with a hashed weight for every
+// seam exit. That is found by Boruvka's algorithm on the pool: each
+// round every set of tiles picks its cheapest seam out and they are
+// all joined at once in a ConcurrentDisjointSet. Each tile is a perfect
+// maze and the joins form a tree so the whole thing is still a perfect
+// maze.
+//
+// Dead end removal and open plan are then done per tile on the pool,
+// with the one sweep rule of OpenPlan.h: the sweep goes through the
+// tiles in order and each tile's cells by row, so a passage between
+// tiles is decided by the later tile. A tile only changes its own
+// cells, what it opens into other tiles is done afterwards.
+//
+// Every random choice comes from (seed, tile) or (seed, exit) and the
+// tile size doesn't depend on the number of threads, so the maze for a
+// seed is the same however many threads are used. It is NOT the same
+// maze Generator would make for that seed. setCounterRandom() draws
+// from a CounterRandom in the tiles and the sweep instead.
+//
+// The up tree bits are a shortest path tree from the start (along y
+// then x) rather than Generator's creation order, but mean the same
+// thing: following the down tree exits from the start visits every cell
+// once. For singlePath the end loc is the end of the longest path in
+// the start's tile.
+//
+namespace Maze {
+
+class ThreadPool;
+
+class ParallelGenerator : public SquareGenerator
+{
+public:
+    enum { DEFAULT_TILE_SIZE = 256 };
+
+    // numThreads of 0 => one per core
+    ParallelGenerator(const MazeData& rMazeData,
+                      int numThreads = 0,
+                      int tileSize = DEFAULT_TILE_SIZE);
+
+    virtual ~ParallelGenerator();
+
+    // Generate on the pool instead of the one made for numThreads, 0 to
+    // go back to that one
+    virtual void setThreadPool(ThreadPool* pThreadPool);
+
+    // Generate the maze for the seed
+    // NOTE: This is a new PackedMaze which must be deleted by caller
+    virtual PackedMaze* generate(unsigned int seed = 0);
+
+protected:
+    enum { SEAM_EAST = 0, SEAM_SOUTH, NUM_SEAMS };
+
+    // A possible join between two tiles
+    struct SeamExit {
+        std::uint64_t m_weight;
+        int           m_cell;
+        int           m_exitNum;
+        int           m_tile1;
+        int           m_tile2;
+        bool operator<(const SeamExit& rOther) const
+        {
+            return (m_weight != rOther.m_weight)
+                ? (m_weight < rOther.m_weight)
+                : (seamKey() < rOther.seamKey());
+        }
+        std::uint64_t seamKey() const
+        {
+            return std::uint64_t(m_cell) * NUM_EXITS + m_exitNum;
+        }
+    };
+
+    int getTileOf(int cell) const;
+
+    void makeTile(int tile, unsigned int seed);
+    void findSeamExit(int tile, int exitNum, unsigned int seed);
+    void joinTiles();
+    // Make the seam the set's cheapest if it is cheaper
+    void keepCheapest(std::atomic<int>& rCheapest, int seam) const;
+    void setUpTree(int tile);
+    void removeDeadEndsAndOpenPlan(int tile, unsigned int seed);
+    template <typename T_DRAWS>
+    void sweepTile(int tile, RNG::I_Random& rRNG, T_DRAWS* pDraws);
+
+    // Open an exit from a cell in the tile. If it leads to another tile
+    // only this side is opened now, the other side is done later
+    void openTileExit(int tile, int cell, int exitNum);
+
+protected:
+    // The pool made for numThreads (SquareGenerator's m_pThreadPool is
+    // the one used)
+    ThreadPool* m_pOwnThreadPool;
+    int         m_tileSize;
+    int         m_tilesX;
+    int         m_tilesY;
+
+    // Best seam exit going EAST and SOUTH from each tile as
+    // tile*NUM_SEAMS + SEAM_EAST/SOUTH (m_cell -1 if none)
+    std::vector<SeamExit> m_seams;
+    ConcurrentDisjointSet m_joinedTiles;
+    // Per tile: exits into other tiles still to open on the other side
+    // (as cell*NUM_EXITS + exitNum of that side, 64 bit so any number
+    // of cells fits)
+    std::vector<std::vector<std::uint64_t> > m_deferredExits;
+
+    CellLoc     m_endLoc;
+};
+
+} // namespace
+
+#endif
@@ -0,0 +1,122 @@
+#ifndef MAZE_PATH_ORACLE_H
+#define MAZE_PATH_ORACLE_H
+
+#include <vector>
+
+//
+// Answers "how far from A to B" and "which way from A to get to B" for
+// a perfect maze (one path between any two cells, e.g. singlePath with
+// no noDeadEnds or openPlanChance) without searching, for when lots of
+// queries are needed e.g. every NPC every tick.
+//
+// Built once from the open exits in a Solver. (The Nodes' UPTREE flags
+// can't be used for this, they give the order the Nodes were made in,
+// not the maze.) The maze is a tree hanging from rootCell and the cells
+// are numbered in depth first order, so a cell's subtree is the range
+// of numbers [getOrder(cell), getOrder(cell) + subtree size). The least
+// deep cell between two cells in that order is then a child of their
+// lowest common ancestor (LCA), found in constant time with a sparse
+// table of block minimums plus a scan of at most two blocks.
+//
+// - getDistance  depth(A) + depth(B) - 2 * depth(LCA)
+// - getNextCell  if B is under A then the child of A that B is under
+//                (the same search), otherwise A's parent
+//
+// If the maze has loops the answers are for the depth first tree i.e.
+// a path, but not always the shortest one. isPerfect() says which.
+// Cells that can't be reached from rootCell have no answers.
+//
+namespace Maze {
+
+class Solver;
+
+class PathOracle
+{
+public:
+    enum { UNREACHABLE = -1 };
+
+    PathOracle(const Solver& rSolver, int rootCell);
+    virtual ~PathOracle();
+
+    int getNumCells() const { return m_depths.size(); }
+    int getRootCell() const { return m_order.empty() ? -1 : m_order[0]; }
+
+    // True if there were no loops i.e. the answers are the shortest paths
+    bool isPerfect() const { return m_isPerfect; }
+
+    bool isReachable(int cell) const { return m_depths[cell] >= 0; }
+    // Steps from the root (UNREACHABLE if can't get there)
+    int getDepth(int cell) const { return m_depths[cell]; }
+    // Cell one step nearer the root, -1 for the root
+    int getParent(int cell) const { return m_parents[cell]; }
+    // Position in depth first order
+    int getOrder(int cell) const { return m_orderIdxs[cell]; }
+
+    // True if cell is ancestor or is below it
+    bool isUnder(int cell, int ancestor) const
+    {
+        const unsigned int l_offset =
+            m_orderIdxs[cell] - m_orderIdxs[ancestor];
+        return isReachable(cell) and isReachable(ancestor)
+           and (l_offset < (unsigned int)m_subtreeSizes[ancestor]);
+    }
+
+    // Lowest cell both are under, -1 if either is unreachable
+    int getLCA(int cellA, int cellB) const;
+
+    // Steps from A to B, UNREACHABLE if either is unreachable
+    int getDistance(int cellA, int cellB) const;
+
+    // The cell to go to from A to get to B, -1 if A == B or unreachable
+    int getNextCell(int cellA, int cellB) const;
+
+    // All the cells from A to B (both included), empty if unreachable
+    void getPath(int cellA, int cellB, std::vector<int>& rPath) const;
+
+    // Bytes used
+    long getMemoryUsed() const;
+
+protected:
+    enum { BLOCK_BITS = 5, BLOCK_SIZE = 1 << BLOCK_BITS };
+
+    void makeOrder(const Solver& rSolver, int rootCell);
+    void makeBlockTable();
+
+    // Position of the least deep cell in order positions first..last
+    // (the last of them if more than one)
+    int findLeastDeep(int first, int last) const;
+    int leastDeep(int posA, int posB) const
+    {
+        const int l_depthA = m_orderDepths[posA];
+        const int l_depthB = m_orderDepths[posB];
+        return ((l_depthA < l_depthB)
+                or ((l_depthA == l_depthB) and (posA > posB))) ? posA : posB;
+    }
+
+protected:
+    bool m_isPerfect;
+
+    // Per cell
+    std::vector<int> m_depths;
+    std::vector<int> m_parents;
+    std::vector<int> m_orderIdxs;
+    std::vector<int> m_subtreeSizes;
+
+    // Per position in depth first order (reachable cells only)
+    std::vector<int> m_order;
+    std::vector<int> m_orderDepths;
+
+    // m_blockTable[level * m_numBlocks + b] = position of the least deep
+    // cell in the 2^level blocks from block b
+    int              m_numBlocks;
+    std::vector<int> m_blockTable;
+    std::vector<unsigned char> m_log2s;
+
+private:
+    PathOracle(const PathOracle&);
+    PathOracle& operator=(const PathOracle&);
+};
+
+} // namespace
+
+#endif
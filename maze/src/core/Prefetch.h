@@ -0,0 +1,19 @@
+#ifndef MAZE_PREFETCH_H
+#define MAZE_PREFETCH_H
+
+//
+// Hint that the memory at the address will be read soon.
+// Used where a loop knows the random locations it will read a few
+// steps ahead (e.g. shuffling or union-find over a big maze)
+//
+#if defined(__GNUC__) || defined(__clang__)
+#define MAZE_PREFETCH(pAddr) __builtin_prefetch(pAddr)
+#elif defined(_MSC_VER)
+#include <xmmintrin.h>
+#define MAZE_PREFETCH(pAddr) \
+    _mm_prefetch(reinterpret_cast<const char*>(pAddr), _MM_HINT_T0)
+#else
+#define MAZE_PREFETCH(pAddr)
+#endif
+
+#endif
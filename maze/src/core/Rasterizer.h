@@ -0,0 +1,104 @@
+#ifndef MAZE_RASTERIZER_H
+#define MAZE_RASTERIZER_H
+
+//
+// Turns a generated 2D square maze into a grid of wall and floor tiles,
+// the way a tile map shows it.
+//
+// Each room (maze cell) is roomWidth x roomHeight tiles with a wall
+// wallWidth/wallHeight thick between it and the next room (shared, so
+// the grid is rooms * (room + wall) + wall tiles across). An open exit
+// is a door doorWidth/doorHeight wide in the middle of the wall. With
+// smoothWalls the bits of wall sticking out into a corridor where two
+// rooms join in a line are removed too.
+//
+// e.g. two 3x3 rooms joined by a 1 tile door with 1 tile walls:
+//
+//   #########
+//   #   #   #     # = TILE_WALL
+//   #   .   #     . = TILE_FLOOR (doors and smoothing)
+//   #   #   #       = TILE_EMPTY (inside the rooms)
+//   #########
+//
+// rasterize() makes each distinct row of tiles once, filling runs of the
+// same tile with memset, and passes the rows in order to an I_TileSink.
+// The rows of a wall are all the same, as are the rows of a row of rooms
+// that cross the same part of the walls between the rooms (beside the
+// door, the door itself, ...), so most rows are just passed again. It
+// can also write the whole grid into a flat buffer (row y starts at
+// y * getWidth()) for a frontend that wants it all at once.
+//
+namespace Maze {
+
+class I_TileSink;
+class PackedMaze;
+
+class Rasterizer
+{
+public:
+    enum Tile {
+        TILE_EMPTY = 0,
+        TILE_WALL,
+        TILE_FLOOR
+    };
+
+    Rasterizer();
+    virtual ~Rasterizer();
+
+    // Sizes in tiles
+    void setRoomSize(int width, int height);
+    void setWallSize(int width, int height);
+    void setDoorSize(int width, int height);
+    void setSmoothWalls(bool smoothWalls);
+
+    // Size of the grid for a maze of rooms
+    int getWidth(int roomsWide) const
+    {
+        return roomsWide * (m_roomWidth + m_wallWidth) + m_wallWidth;
+    }
+    int getHeight(int roomsTall) const
+    {
+        return roomsTall * (m_roomHeight + m_wallHeight) + m_wallHeight;
+    }
+
+    // Passes the getHeight() rows of getWidth() tiles of rMaze to rSink.
+    // Returns false (and logs why) if rMaze isn't a 2D square maze or
+    // the doors are bigger than the rooms
+    bool rasterize(const PackedMaze& rMaze, I_TileSink& rSink) const;
+    // Writes the getWidth() x getHeight() tiles into pTiles
+    bool rasterize(const PackedMaze& rMaze, unsigned char* pTiles) const;
+
+protected:
+    // The part of the walls between the rooms a row of rooms crosses
+    enum RoomRow {
+        ROW_SIDE_NORTH,   // beside the door, north of it
+        ROW_DOOR,
+        ROW_MIDDLE,       // between door and side if it doesn't divide evenly
+        ROW_SIDE_SOUTH
+    };
+    RoomRow getRoomRow(int roomY) const;
+
+    // Row of a wall between the rooms above and below (0 if none)
+    void fillWallRow(const unsigned char* pAbove,
+                     const unsigned char* pBelow,
+                     int roomsWide,
+                     unsigned char* pRow) const;
+    // Row of a row of rooms
+    void fillRoomRow(const unsigned char* pRooms,
+                     int roomsWide,
+                     RoomRow roomRow,
+                     unsigned char* pRow) const;
+
+protected:
+    int  m_roomWidth;
+    int  m_roomHeight;
+    int  m_wallWidth;
+    int  m_wallHeight;
+    int  m_doorWidth;
+    int  m_doorHeight;
+    bool m_smoothWalls;
+};
+
+} // namespace
+
+#endif
@@ -0,0 +1,123 @@
+#ifndef MAZE_SOLVER_H
+#define MAZE_SOLVER_H
+
+#include <vector>
+
+#include "CellLoc.h"
+#include "MazeData.h"
+
+//
+// Finds paths and distances through a generated maze.
+//
+// Works on the cell indices from MazeData::getCellIndex(). When made the
+// Solver copies which cells each cell's open exits lead to into a flat
+// table, from either a PackedMaze or the Nodes of a MazeData, so every
+// search after that is just array lookups. If the maze changes (e.g.
+// Node::setOpen) call build() again to pick up the changes.
+//
+// - getDistances() fills a distance field: the number of steps from the
+//   nearest of the given cells to every cell (UNREACHABLE if can't get
+//   there). Following getNextCell() from any cell then leads to the
+//   nearest source, which is what an AI flow field needs.
+// - findPath() is an A* search between two cells. It only looks at the
+//   cells it needs to, and doesn't clear anything between searches, so
+//   short paths are cheap however big the maze is.
+//
+// All steps cost 1. A Solver can only be used by one thread at a time
+// (it keeps its scratch storage between searches).
+//
+namespace Maze {
+
+class PackedMaze;
+
+class Solver
+{
+public:
+    enum { UNREACHABLE = -1 };
+
+    // From the packed cells
+    explicit Solver(const PackedMaze& rMaze);
+    // From the Nodes (rMazeData must have a root)
+    explicit Solver(const MazeData& rMazeData);
+    virtual ~Solver();
+
+    // Rebuild the table of open exits. Must be the same maze parameters
+    void build(const PackedMaze& rMaze);
+    void build(const MazeData& rMazeData);
+
+    int getNumCells() const { return m_numOpen.size(); }
+    int getCellIndex(const CellLoc& rLoc) const
+    {
+        return m_mazeData.getCellIndex(rLoc);
+    }
+    CellLoc getCellLoc(int cell) const { return m_mazeData.getCellLoc(cell); }
+
+    // Cells the open exits of cell lead to
+    int getNumOpenCells(int cell) const { return m_numOpen[cell]; }
+    int getOpenCell(int cell, int num) const
+    {
+        return m_openCells[cell * m_maxExits + num];
+    }
+
+    // Breadth first distance field from one or more cells. rDistances
+    // is resized to getNumCells()
+    void getDistances(int fromCell, std::vector<int>& rDistances);
+    void getDistances(const std::vector<int>& rFromCells,
+                      std::vector<int>& rDistances);
+
+    // Cell next to cell that is a step nearer in the distance field, or
+    // -1 if there isn't one (cell is a source or is UNREACHABLE)
+    int getNextCell(const std::vector<int>& rDistances, int cell) const;
+
+    // Shortest path (A*) from fromCell to toCell, both included.
+    // Returns false (and rPath empty) if there is no path
+    bool findPath(int fromCell, int toCell, std::vector<int>& rPath);
+    bool findPath(const CellLoc& rFrom,
+                  const CellLoc& rTo,
+                  std::vector<int>& rPath);
+
+    // Lower bound on the steps from one cell to the other (what A* uses)
+    int getMinDistance(int fromCell, int toCell) const;
+
+protected:
+    void startBuild();
+    void addOpenCell(int cell, int openCell);
+    void finishBuild();
+    int getLocDistance(int fromCell, int toCell) const;
+
+protected:
+    // Only the parameters (not the Nodes)
+    MazeData           m_mazeData;
+    int                m_maxExits;
+    // Most a step changes the coordinates by (summed), for getMinDistance
+    int                m_maxStep;
+
+    // Per cell: how many open exits, and where they lead as
+    // cell * m_maxExits + num
+    std::vector<unsigned char> m_numOpen;
+    std::vector<int>           m_openCells;
+
+    // Scratch for findPath. A cell's m_cost and m_cameFrom are only
+    // valid for this search if its m_searchIds entry is m_searchId
+    struct OpenEntry
+    {
+        int m_estimate;
+        int m_cost;
+        int m_cell;
+    };
+    std::vector<OpenEntry>    m_openList;
+    std::vector<unsigned int> m_searchIds;
+    unsigned int              m_searchId;
+    std::vector<int>          m_cost;
+    // Also the queue for getDistances
+    std::vector<int>          m_cameFrom;
+
+private:
+    // Not needed, keeps the scratch storage simple
+    Solver(const Solver&);
+    Solver& operator=(const Solver&);
+};
+
+} // namespace
+
+#endif
@@ -0,0 +1,147 @@
+#ifndef MAZE_SQUARE_GENERATOR_H
+#define MAZE_SQUARE_GENERATOR_H
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "CounterRandom.h"
+#include "DisjointSet.h"
+#include "MazeData.h"
+#include "PackedMaze.h"
+
+//
+// Fast path for the 2D square maze i.e. the TileData made by
+// MazeHelper::makeSquareTileData (one cell type, exits 0..3 = NSEW).
+//
+// Generates exactly the same maze as Generator does for the same seed
+// and RNG (same Node order, same RNG calls, same exits opened) but works
+// directly on a grid of exit bits, using constant direction tables
+// instead of Nodes, Connections and virtual calls. The result is a
+// PackedMaze.
+//
+// Generator::generatePacked uses this automatically when it can.
+//
+namespace RNG {
+class I_Random;
+}
+
+namespace Maze {
+class ThreadPool;
+
+class SquareGenerator {
+public:
+  enum { NORTH = 0, SOUTH, EAST, WEST, NUM_EXITS };
+
+  SquareGenerator(const MazeData &rMazeData, RNG::I_Random *pRNG);
+
+  virtual ~SquareGenerator();
+
+  // The exit that leads back i.e. N<->S and E<->W
+  static constexpr int reverseExit(int exitNum) { return exitNum ^ 1; }
+
+  // True if the MazeData describes a maze this can generate
+  static bool canGenerate(const MazeData &rMazeData);
+
+  // Do the open plan of big mazes on the pool (see OpenPlan.h), 0 for
+  // none. The maze is the same either way
+  // NOTE: Not a pool that is running this e.g. a BatchGenerator's
+  virtual void setThreadPool(ThreadPool *pThreadPool);
+
+  // As Generator::setCounterRandom (and the same maze as Generator)
+  virtual void setCounterRandom(bool counterRandom);
+
+  // As Generator::setCancelFlag. Polled between the phases and every
+  // CANCEL_POLL_CELLS cells in them
+  virtual void setCancelFlag(const std::atomic<bool> *pCancelled);
+
+  // Generate a maze, if seed is given the pRNG will be init'ed to it
+  // NOTE: This is a new PackedMaze which must be deleted by caller
+  //       Returns 0 if the cancel flag was set
+  virtual PackedMaze *generate(unsigned int seed = 0);
+
+protected:
+  // Cell the exit leads to or -1 if it leads out of the maze
+  int getExitCell(int cell, int exitNum) const {
+    const int l_y = cell / m_width;
+    return getExitCell(cell, cell - l_y * m_width, l_y, exitNum);
+  }
+
+  // As above when already know the cell's x,y
+  int getExitCell(int cell, int x, int y, int exitNum) const {
+    const bool l_onEdge = (exitNum == NORTH)   ? (y == 0)
+                          : (exitNum == SOUTH) ? (y == m_height - 1)
+                          : (exitNum == EAST)  ? (x == m_width - 1)
+                                               : (x == 0);
+    if (not l_onEdge) {
+      return cell + m_indexDeltas[exitNum];
+    }
+    return m_wrapRound ? cell + m_wrapDeltas[exitNum] : -1;
+  }
+
+  void prefetchCell(unsigned int orderIdx) const;
+
+  // How often the loops look at the cancel flag (a power of 2)
+  enum { CANCEL_POLL_CELLS = 4096 };
+  bool isCancelled() const {
+    return m_pCancelled and m_pCancelled->load(std::memory_order_relaxed);
+  }
+  // isCancelled, but only every CANCEL_POLL_CELLS steps of a loop
+  bool pollCancelled(int step) const {
+    return (0 == (step & (CANCEL_POLL_CELLS - 1))) and isCancelled();
+  }
+
+  // For generators that don't create cells in Generator's order:
+  // the up tree bits of a shortest path tree from the start i.e. each
+  // cell's parent is one step nearer the start in y, or if level with
+  // the start, in x (with wrap round going the shorter way round)
+  PackedMaze::ExitMask getShortestPathUpTree(int cell, int x, int y) const;
+  // Direction from the cell one step nearer the start, or -1 if start
+  int getParentExit(int x, int y) const;
+
+  void makeExits();
+  void makeSinglePathMaze();
+  void makeMaze();
+  void removeDeadEndsAndOpenPlan();
+  template <typename T_DRAWS>
+  void sweepCells(int first, int last, bool noDeadEnds, T_DRAWS *pDraws,
+                  std::vector<std::uint64_t> *pDeferred);
+  void openExit(int cell, int exitNum);
+
+protected:
+  MazeData m_mazeData;
+  RNG::I_Random *m_pRNG;
+  // Draw from m_counterRNG instead (see setCounterRandom)
+  bool m_useCounterRNG;
+  CounterRandom m_counterRNG;
+  ThreadPool *m_pThreadPool;
+  const std::atomic<bool> *m_pCancelled;
+
+  int m_width;
+  int m_height;
+  int m_numCells;
+  bool m_wrapRound;
+  int m_startX;
+  int m_startY;
+  int m_indexDeltas[NUM_EXITS];
+  // Change in index when the exit wraps round to the other side
+  int m_wrapDeltas[NUM_EXITS];
+
+  std::vector<PackedMaze::ExitMask> m_openMasks;
+  std::vector<PackedMaze::ExitMask> m_upTreeMasks;
+
+  // Cells in the order Generator would create the Nodes
+  std::vector<int> m_cellOrder;
+  // Where each cell is in m_cellOrder (for the open plan)
+  std::vector<int> m_sweepPos;
+  // Per open plan chunk, exits it opened into earlier chunks as
+  // cell*NUM_EXITS + exitNum (64 bit so any number of cells fits)
+  std::vector<std::vector<std::uint64_t>> m_deferredExits;
+  // Every real exit as cell*NUM_EXITS + exitNum
+  std::vector<unsigned int> m_exitList;
+  DisjointSet m_connectedSets;
+};
+
+} // namespace Maze
+
+#endif
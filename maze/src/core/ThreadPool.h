@@ -0,0 +1,68 @@
+#ifndef MAZE_THREAD_POOL_H
+#define MAZE_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//
+// A fixed set of threads that are started once and then reused for
+// every parallelFor(), so a batch doesn't pay for creating threads.
+//
+// The calling thread works too i.e. a pool of N threads starts N-1.
+// Items are handed out one at a time from a shared counter so a thread
+// that gets quick items just takes more of them.
+//
+namespace Maze {
+
+class ThreadPool
+{
+public:
+    // numThreads of 0 => one per core
+    explicit ThreadPool(int numThreads = 0);
+    ~ThreadPool();
+
+    int getNumThreads() const { return m_numThreads; }
+
+    // Call rFn(item, thread) for every item 0..numItems-1 and wait for
+    // them all. thread is 0..getNumThreads()-1 and no two calls at the
+    // same time have the same thread number, so it can index per thread
+    // data. If any call throws the first exception is rethrown here
+    // (the remaining items are skipped).
+    // NOTE: Only one parallelFor at a time
+    void parallelFor(int numItems,
+                     const std::function<void(int item, int thread)>& rFn);
+
+protected:
+    void workerMain(int thread);
+    void runItems(int thread);
+
+protected:
+    int                      m_numThreads;
+    std::vector<std::thread> m_threads;
+
+    std::mutex               m_mutex;
+    std::condition_variable  m_startCond;
+    std::condition_variable  m_doneCond;
+
+    // Current job (guarded by m_mutex apart from the atomics)
+    const std::function<void(int, int)>* m_pFn;
+    int                      m_numItems;
+    std::atomic<int>         m_nextItem;
+    unsigned int             m_jobNum;
+    int                      m_numWorking;
+    bool                     m_stop;
+    std::exception_ptr       m_exception;
+
+private:
+    ThreadPool(const ThreadPool&);
+    ThreadPool& operator=(const ThreadPool&);
+};
+
+} // namespace
+
+#endif
@@ -37,6 +37,8 @@
 //
 // To extend this to 3D the Cell Locations would have 3 values instead of 2
 // and 2 more Connections would be needed (for the up and down exits).
+// Any number of dimensions is supported, though a MazeFile only stores up
+// to CellLoc::MAX_DIMS (4).
 //
 // NOTE: Connections don't have any IDs/Types, instead the order you define
 // them is their ID e.g. defining 4 Connections will mean each Node in the
@@ -49,6 +51,13 @@
 // a connection from type1 to type0 (and locChange should be reversed).
 // Done this way since might want to add support for one-way Connections.
 //
+// Once all the Connections are defined the TileData can be compiled for
+// a set of maze dimensions (MazeData does this whenever its TileData or
+// dimensions are set). Compiling groups the Connections by cell type so
+// the lookups don't search the list, finds the reverse of each
+// Connection and works out how much each one changes the cell index.
+// Defining another Connection undoes the compile.
+//
 namespace Maze {
 
 class TileData
@@ -77,16 +86,58 @@ public:
     // Returns the number of connections for that cell type
     virtual int getNumConnections(const CellType& rFromCellType) const;
 
+    // Returns the most connections any cell type has
+    virtual int getMaxConnections() const;
+
     // Returns a Connection (conNum = 0...getNumConnections-1)
     // 0 returned if not found or conNum too large
     virtual const Connection* getConnection(const CellType& rFromCellType,
                                             int conNum) const;
 
+    // All the Connections in the order they were defined
+    // (definedNum = 0...getNumDefinedConnections-1)
+    virtual int getNumDefinedConnections() const;
+    virtual const Connection& getDefinedConnection(int definedNum) const;
+
+    // Build the lookup tables for the given maze dimensions
+    virtual void compile(const CellLoc& rDimensions);
+    virtual bool isCompiled() const { return m_compiled; }
+
+    // The following need the TileData to be compiled
+
+    // Returns the number of the Connection of the toCellType that leads
+    // back again (i.e. opposite locChange) or -1 if there isn't one
+    // (or not compiled, or no such Connection)
+    virtual int getReverseConnection(const CellType& rFromCellType,
+                                     int conNum) const;
+
+    // Returns how much the Connection changes the cell index
+    // (see MazeData::getCellIndex) ignoring any wrapping.
+    // Asserts it is compiled, 0 if not or no such Connection
+    virtual int getIndexDelta(const CellType& rFromCellType,
+                              int conNum) const;
+
+protected:
+    // Position of the cell type in m_compiledTypes or -1
+    int getTypeSlot(const CellType& rCellType) const;
+
 protected:
     CellType                        m_firstCellType;
 
     typedef std::vector<Connection> ConnectionList;
     ConnectionList                  m_connections;
+
+    // Compiled form. Each from cell type has a slot in m_compiledTypes
+    // (sorted) which gives the first entry and number of entries of its
+    // Connections in the per Connection arrays
+    bool                            m_compiled;
+    std::vector<CellType>           m_compiledTypes;
+    std::vector<int>                m_conOffsets;
+    std::vector<int>                m_conCounts;
+    // Per Connection (grouped by from cell type)
+    std::vector<int>                m_conIndices; // into m_connections
+    std::vector<int>                m_reverseCons;
+    std::vector<int>                m_indexDeltas;
 };
 
 } // namespace
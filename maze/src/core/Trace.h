@@ -0,0 +1,40 @@
+#ifndef MAZE_TRACE_H
+#define MAZE_TRACE_H
+
+#include "GenerationStats.h"
+
+#include "Debug.h"
+
+//
+// Logging and trace spans for the generation loops.
+//
+// Even when the logging is off LOG_DEBUG/LOG_INFO still ask the Debug
+// singleton each time, which shows up in loops run for every exit (e.g.
+// Node::addExit). Building with MAZE_NO_HOT_LOGGING defined (CMake
+// option MAZE_HOT_LOGGING=OFF) makes these compile to nothing, so the
+// loops have no logging or tracing in them at all.
+//
+// MAZE_TRACE_SPAN(rStats, "name") times the rest of the scope as a span
+// of the GenerationStats when it is tracing.
+//
+#ifdef MAZE_NO_HOT_LOGGING
+
+#define MAZE_LOG_DEBUG(x) do { } while (false)
+#define MAZE_LOG_INFO(x) do { } while (false)
+#define MAZE_DEBUG_ON() false
+#define MAZE_TRACE_SPAN(rStats, pName) do { } while (false)
+
+#else
+
+#define MAZE_LOG_DEBUG(x) LOG_DEBUG(x)
+#define MAZE_LOG_INFO(x) LOG_INFO(x)
+#define MAZE_DEBUG_ON() (Util::Debug::instance()->debugOn())
+#define MAZE_TRACE_SPAN_NAME2(line) l_traceSpan##line
+#define MAZE_TRACE_SPAN_NAME(line) MAZE_TRACE_SPAN_NAME2(line)
+#define MAZE_TRACE_SPAN(rStats, pName) \
+    Maze::GenerationStats::TraceSpan MAZE_TRACE_SPAN_NAME(__LINE__)( \
+        rStats, pName)
+
+#endif
+
+#endif
@@ -1,22 +1,53 @@
 #include "MazeData.h"
 #include "MazeHelper.h"
+#include "PackedMaze.h"
+#include "Rasterizer.h"
 #include <cute.h>
+#include <vector>
 
 // This class is just a wrapper to prove both libraries can talk to each other
 class CuteMaze {
 
 public:
   CuteMaze(int width, int height) {
-    pMaze = Maze::MazeHelper::generateSquareMaze(width, height, 0, 0, false,
-                                                 false, false, 50, 4242);
+    pMaze = Maze::MazeHelper::generateSquarePackedMaze(
+        width, height, 0, 0, false, false, false, 50, 4242);
+
+    // Same tiles as GDMaze
+    Maze::Rasterizer l_rasterizer;
+    mTilesWide = l_rasterizer.getWidth(width);
+    mTilesTall = l_rasterizer.getHeight(height);
+    mTiles.resize(size_t(mTilesWide) * mTilesTall);
+    l_rasterizer.rasterize(*pMaze, mTiles.data());
   }
   ~CuteMaze() { delete pMaze; }
 
+  // Draws each run of wall tiles along a row as one box
   void draw() {
+    const float tileSize = 8.0f;
     Cute::draw_push_color(Cute::color_white());
-    Cute::draw_line(cf_v2(0, 0), cf_v2(100, 100), 2.0f);
+    for (int y = 0; y < mTilesTall; ++y) {
+      const unsigned char *pRow = &mTiles[size_t(y) * mTilesWide];
+      for (int x = 0; x < mTilesWide;) {
+        if (pRow[x] != Maze::Rasterizer::TILE_WALL) {
+          ++x;
+          continue;
+        }
+        const int start = x;
+        while ((x < mTilesWide) && (pRow[x] == Maze::Rasterizer::TILE_WALL)) {
+          ++x;
+        }
+        const CF_V2 min = cf_v2(start * tileSize, -(y + 1) * tileSize);
+        const CF_V2 max = cf_v2(x * tileSize, -y * tileSize);
+        Cute::draw_box_fill(cf_make_aabb(min, max));
+      }
+    }
+    Cute::draw_pop_color();
   }
 
 private:
-  Maze::MazeData *pMaze;
+  Maze::PackedMaze *pMaze;
+  int mTilesWide;
+  int mTilesTall;
+  std::vector<unsigned char> mTiles;
 };
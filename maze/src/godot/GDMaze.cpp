@@ -1,15 +1,129 @@
 #include "GDMaze.hpp"
+#include "I_TileSink.h"
 #include "MazeData.h"
 #include "MazeHelper.h"
-#include "Node.h"
+#include "PackedMaze.h"
+#include "Rasterizer.h"
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <thread>
 #include <gdextension_interface.h>
+#include <godot_cpp/classes/engine.hpp>
+#include <godot_cpp/classes/scene_tree.hpp>
 #include <godot_cpp/core/class_db.hpp>
 #include <godot_cpp/core/error_macros.hpp>
+#include <godot_cpp/core/object.hpp>
 #include <godot_cpp/godot.hpp>
+#include <godot_cpp/variant/callable.hpp>
+#include <godot_cpp/variant/packed_byte_array.hpp>
 #include <godot_cpp/variant/vector2.hpp>
 
 using namespace godot;
 
+namespace {
+
+// Tile map data: u16 format then per tile i16 x, y, u16 source, atlas
+// x, y, alternative (all little endian). Empty tiles are left out
+class TileDataSink : public Maze::I_TileSink {
+public:
+  TileDataSink(Vector2i wall, Vector2i floor) : mWall(wall), mFloor(floor) {
+    mData.resize(2);
+    mData.fill(0);
+  }
+
+  void addRow(int y, const unsigned char *pTiles, int width) override {
+    int numTiles = 0;
+    for (int x = 0; x < width; ++x) {
+      numTiles += (pTiles[x] != Maze::Rasterizer::TILE_EMPTY);
+    }
+    const int64_t used = mData.size();
+    mData.resize(used + numTiles * TILE_BYTES);
+    uint8_t *pOut = mData.ptrw() + used;
+    for (int x = 0; x < width; ++x) {
+      if (pTiles[x] != Maze::Rasterizer::TILE_EMPTY) {
+        const Vector2i &rAtlas =
+            (pTiles[x] == Maze::Rasterizer::TILE_WALL) ? mWall : mFloor;
+        pOut = put16(pOut, x);
+        pOut = put16(pOut, y);
+        pOut = put16(pOut, 0);
+        pOut = put16(pOut, rAtlas.x);
+        pOut = put16(pOut, rAtlas.y);
+        pOut = put16(pOut, 0);
+      }
+    }
+  }
+
+  const PackedByteArray &getData() const { return mData; }
+
+private:
+  enum { TILE_BYTES = 12 };
+
+  static uint8_t *put16(uint8_t *pOut, int value) {
+    pOut[0] = value & 0xff;
+    pOut[1] = (value >> 8) & 0xff;
+    return pOut + 2;
+  }
+
+  Vector2i mWall;
+  Vector2i mFloor;
+  PackedByteArray mData;
+};
+
+// One set_cell per (non-empty) tile
+class SetCellSink : public Maze::I_TileSink {
+public:
+  SetCellSink(TileMapLayer *pTileMap, Vector2i wall, Vector2i floor)
+      : mpTileMap(pTileMap), mWall(wall), mFloor(floor) {}
+
+  void addRow(int y, const unsigned char *pTiles, int width) override {
+    for (int x = 0; x < width; ++x) {
+      if (pTiles[x] != Maze::Rasterizer::TILE_EMPTY) {
+        mpTileMap->set_cell(
+            Vector2i(x, y), 0,
+            (pTiles[x] == Maze::Rasterizer::TILE_WALL) ? mWall : mFloor);
+      }
+    }
+  }
+
+private:
+  TileMapLayer *mpTileMap;
+  Vector2i mWall;
+  Vector2i mFloor;
+};
+
+// Rows into the AsyncJob's tiles, on the make_maze_async worker thread.
+// Rasterizing is the second quarter of the progress
+class ProgressSink : public Maze::I_TileSink {
+public:
+  ProgressSink(unsigned char *pTiles, int height,
+               std::atomic<float> &rProgress,
+               const std::atomic<bool> &rCancelled)
+      : mpTiles(pTiles), mHeight(height), mrProgress(rProgress),
+        mrCancelled(rCancelled) {}
+
+  void addRow(int y, const unsigned char *pTiles, int width) override {
+    if (!mrCancelled) {
+      std::memcpy(mpTiles + size_t(y) * width, pTiles, width);
+      mrProgress = 0.25f + 0.25f * (y + 1) / mHeight;
+    }
+  }
+
+private:
+  unsigned char *mpTiles;
+  int mHeight;
+  std::atomic<float> &mrProgress;
+  const std::atomic<bool> &mrCancelled;
+};
+
+typedef std::chrono::steady_clock Clock;
+
+SceneTree *getSceneTree() {
+  return Object::cast_to<SceneTree>(Engine::get_singleton()->get_main_loop());
+}
+
+} // namespace
+
 void GDMaze::_bind_methods() {
   ClassDB::bind_method(D_METHOD("set_rooms", "mazeSize"), &GDMaze::setRooms);
   ClassDB::bind_method(D_METHOD("set_room_cell_size", "cells"),
@@ -36,6 +150,21 @@ void GDMaze::_bind_methods() {
                        &GDMaze::setWall);
   ClassDB::bind_method(D_METHOD("make_maze", "pTileMap", "layer", "seed"),
                        &GDMaze::make_it);
+
+  ClassDB::bind_method(
+      D_METHOD("make_maze_async", "pTileMap", "layer", "seed"),
+      &GDMaze::make_it_async);
+  ClassDB::bind_method(D_METHOD("cancel"), &GDMaze::cancel);
+  ClassDB::bind_method(D_METHOD("is_busy"), &GDMaze::isBusy);
+  ClassDB::bind_method(D_METHOD("get_progress"), &GDMaze::getProgress);
+  ClassDB::bind_method(D_METHOD("set_frame_budget", "ms"),
+                       &GDMaze::setFrameBudget);
+  ClassDB::bind_method(D_METHOD("_on_tiles_ready", "job"),
+                       &GDMaze::onTilesReady);
+  ClassDB::bind_method(D_METHOD("_apply_tiles_frame"),
+                       &GDMaze::applyTilesFrame);
+  ADD_SIGNAL(MethodInfo("tiles_ready"));
+  ADD_SIGNAL(MethodInfo("maze_made"));
 }
 
 GDMaze::GDMaze() {
@@ -43,7 +172,10 @@ GDMaze::GDMaze() {
   mWall = Vector2i(0, 1);
 }
 
-GDMaze::~GDMaze() {}
+GDMaze::~GDMaze() {
+  cancel();
+  joinWorker();
+}
 
 GDMaze *GDMaze::setRooms(Vector2i mazeSize) {
   mRoomsWide = mazeSize.x;
@@ -103,177 +235,231 @@ GDMaze *GDMaze::setWall(godot::Vector2i wall) {
   return this;
 }
 
+GDMaze *GDMaze::setFrameBudget(float ms) {
+  mFrameBudgetMs = ms;
+  return this;
+}
+
 void GDMaze::make_it(TileMapLayer *pTileMap, int layer, int seed) {
-  if (mDoorWidth > mRoomWidth) {
-    ERR_PRINT("Door width must be <= Room width");
-    return;
-  }
-  if (mDoorHeight > mRoomHeight) {
-    ERR_PRINT("Door height must be <= Room height");
+  if (!checkSizes()) {
     return;
   }
 
-  Maze::MazeData *pMaze = Maze::MazeHelper::generateSquareMaze(
+  Maze::PackedMaze *pMaze = Maze::MazeHelper::generateSquarePackedMaze(
       mRoomsWide, mRoomsTall, mStartRoomX, mStartRoomY, mWrapAround,
       mSinglePath, mNoDeadEnds, mOpenPlanChance, seed);
 
-  // Make a grid of walls
-  Maze::Node *pRoot = pMaze->getRoot();
-  for (int ry = 0; ry < mRoomsTall; ++ry) {
-    for (int rx = 0; rx < mRoomsWide; ++rx) {
-      const Maze::Node *l_pNode = Maze::MazeHelper::findNode(pRoot, rx, ry);
-      Vector2i roomCorner = roomToCell(rx, ry);
-
-      // North+South walls
-      for (int cy = 0; cy < mWallHeight; ++cy) {
-        for (int cx = 0; cx < mWallWidth * 2 + mRoomWidth; ++cx) {
-          // North
-          Vector2i coords(roomCorner.x + cx, roomCorner.y + cy);
-          pTileMap->set_cell(coords, 0, mWall);
-          // South
-          coords.y += mRoomHeight + mWallHeight;
-          pTileMap->set_cell(coords, 0, mWall);
-        }
-      }
-      // East+West walls
-      for (int cy = 0; cy < mWallHeight * 2 + mRoomHeight; ++cy) {
-        for (int cx = 0; cx < mWallWidth; ++cx) {
-          // West
-          Vector2i coords(roomCorner.x + cx, roomCorner.y + cy);
-          pTileMap->set_cell(coords, 0, mWall);
-          // East
-          coords.x += mRoomWidth + mWallWidth;
-          pTileMap->set_cell(coords, 0, mWall);
-        }
-      }
+  // Make the tiles a row at a time straight into Godot's tile map data
+  // format and set that, which is one call into Godot instead of a
+  // set_cell per tile. The format only has 16 bit coordinates so very
+  // big mazes fall back to set_cell
+  const Maze::Rasterizer l_rasterizer = makeRasterizer();
+  bool rasterized = false;
+  if ((l_rasterizer.getWidth(mRoomsWide) > 0x7fff) ||
+      (l_rasterizer.getHeight(mRoomsTall) > 0x7fff)) {
+    pTileMap->clear();
+    SetCellSink l_sink(pTileMap, mWall, mFloor);
+    rasterized = l_rasterizer.rasterize(*pMaze, l_sink);
+  } else {
+    TileDataSink l_sink(mWall, mFloor);
+    rasterized = l_rasterizer.rasterize(*pMaze, l_sink);
+    if (rasterized) {
+      pTileMap->set_tile_map_data_from_array(l_sink.getData());
     }
   }
+  delete pMaze;
+  if (!rasterized) {
+    ERR_PRINT("Can't make the maze tiles");
+  }
+}
 
-  // Delete openings
-  for (int ry = 0; ry < mRoomsTall; ++ry) {
-    for (int rx = 0; rx < mRoomsWide; ++rx) {
-      const Maze::Node *l_pNode = Maze::MazeHelper::findNode(pRoot, rx, ry);
-      Vector2i roomCorner = roomToCell(rx, ry);
-
-      const int offsetX = mWallWidth + (mRoomWidth - mDoorWidth) / 2;
-      // North exit
-      if (l_pNode->isOpen(0)) {
-        for (int cy = 0; cy < mWallHeight; ++cy) {
-          for (int cx = 0; cx < mDoorWidth; ++cx) {
-            Vector2i coords(roomCorner.x + offsetX + cx, roomCorner.y + cy);
-            pTileMap->set_cell(coords, 0, mFloor);
-          }
-        }
-      }
-      // South exit
-      if (l_pNode->isOpen(1)) {
-        for (int cy = 0; cy < mWallHeight; ++cy) {
-          for (int cx = 0; cx < mDoorWidth; ++cx) {
-            Vector2i coords(roomCorner.x + offsetX + cx,
-                            roomCorner.y + mRoomHeight + mWallHeight + cy);
-            pTileMap->set_cell(coords, 0, mFloor);
-          }
-        }
-      }
+///////////////////////////////////////////////////
 
-      const int offsetY = mWallHeight + (mRoomHeight - mDoorHeight) / 2;
-      // East exit
-      if (l_pNode->isOpen(2)) {
-        for (int cx = 0; cx < mWallWidth; ++cx) {
-          for (int cy = 0; cy < mDoorHeight; ++cy) {
-            Vector2i coords(roomCorner.x + mRoomWidth + mWallWidth + cx,
-                            roomCorner.y + offsetY + cy);
-            pTileMap->set_cell(coords, 0, mFloor);
-          }
-        }
-      }
-      // West exit
-      if (l_pNode->isOpen(3)) {
-        for (int cx = 0; cx < mWallWidth; ++cx) {
-          for (int cy = 0; cy < mDoorHeight; ++cy) {
-            Vector2i coords(roomCorner.x + cx, roomCorner.y + offsetY + cy);
-            pTileMap->set_cell(coords, 0, mFloor);
-          }
-        }
+bool GDMaze::make_it_async(TileMapLayer *pTileMap, int layer, int seed) {
+  if (mAsyncState != ASYNC_IDLE) {
+    ERR_PRINT("Already making a maze");
+    return false;
+  }
+  if (!checkSizes()) {
+    return false;
+  }
+
+  // The last worker has finished or been cancelled, so won't be long
+  joinWorker();
+  mpJob = std::make_shared<AsyncJob>();
+  mpJob->mOnReady = Callable(this, "_on_tiles_ready");
+  const int job = ++mJobNumber;
+  mProgress = 0.0f;
+  mTileMapId = pTileMap->get_instance_id();
+  mAsyncAtlas[Maze::Rasterizer::TILE_WALL] = mWall;
+  mAsyncAtlas[Maze::Rasterizer::TILE_FLOOR] = mFloor;
+  const Maze::Rasterizer l_rasterizer = makeRasterizer();
+  mTilesWide = l_rasterizer.getWidth(mRoomsWide);
+  mTilesTall = l_rasterizer.getHeight(mRoomsTall);
+  mAppliedRows = 0;
+  mAsyncState = ASYNC_GENERATING;
+
+  // Copies of the settings so they can change while it runs
+  const int roomsWide = mRoomsWide;
+  const int roomsTall = mRoomsTall;
+  const int startX = mStartRoomX;
+  const int startY = mStartRoomY;
+  const bool wrap = mWrapAround;
+  const bool singlePath = mSinglePath;
+  const bool noDeadEnds = mNoDeadEnds;
+  const int openPlanChance = mOpenPlanChance;
+  const int tilesWide = mTilesWide;
+  const int tilesTall = mTilesTall;
+  const std::shared_ptr<AsyncJob> pJob = mpJob;
+  mWorker = std::thread([=]() {
+    // 0 if cancelled part way
+    Maze::PackedMaze *pMaze = Maze::MazeHelper::generateSquarePackedMaze(
+        roomsWide, roomsTall, startX, startY, wrap, singlePath, noDeadEnds,
+        openPlanChance, seed, &pJob->mCancelled);
+    pJob->mProgress = 0.25f;
+    if (pMaze && !pJob->mCancelled) {
+      pJob->mTiles.resize(size_t(tilesWide) * tilesTall);
+      ProgressSink l_sink(pJob->mTiles.data(), tilesTall, pJob->mProgress,
+                          pJob->mCancelled);
+      if (!l_rasterizer.rasterize(*pMaze, l_sink)) {
+        pJob->mTiles.clear();
       }
     }
+    delete pMaze;
+    // Back on the main thread (unless the GDMaze has forgotten the job,
+    // maybe by being freed)
+    if (!pJob->mCancelled) {
+      pJob->mOnReady.call_deferred(job);
+    }
+  });
+  return true;
+}
+
+// A worker still generating stops at its next look at the cancel flag.
+// Nothing waits for it here, it is joined later (see joinWorker)
+void GDMaze::cancel() {
+  if (mpJob) {
+    mpJob->mCancelled = true;
+  }
+  if (mAsyncState == ASYNC_APPLYING) {
+    stopApplying();
+  }
+  mpJob.reset();
+  mAsyncState = ASYNC_IDLE;
+}
+
+bool GDMaze::isBusy() const { return mAsyncState != ASYNC_IDLE; }
+
+float GDMaze::getProgress() const {
+  return (mAsyncState == ASYNC_GENERATING) ? mpJob->mProgress.load()
+                                           : mProgress;
+}
+
+///////////////////////////////////////////////////
+
+void GDMaze::onTilesReady(int job) {
+  if ((job != mJobNumber) || (mAsyncState != ASYNC_GENERATING)) {
+    // A job that has been cancelled
+    return;
+  }
+  // Done once it has queued this call
+  joinWorker();
+  TileMapLayer *pTileMap =
+      Object::cast_to<TileMapLayer>(ObjectDB::get_instance(mTileMapId));
+  if (mpJob->mTiles.empty() || !pTileMap) {
+    ERR_PRINT("Can't make the maze tiles");
+    mpJob.reset();
+    mAsyncState = ASYNC_IDLE;
+    return;
+  }
+
+  mProgress = 0.5f;
+  mAsyncState = ASYNC_APPLYING;
+  emit_signal("tiles_ready");
+  if (mAsyncState != ASYNC_APPLYING) {
+    // Cancelled by whatever got the signal
+    return;
+  }
+  pTileMap->clear();
+  SceneTree *pTree = getSceneTree();
+  if (pTree) {
+    pTree->connect("process_frame", Callable(this, "_apply_tiles_frame"));
+  } else {
+    // All at once
+    applyTiles(1e9f);
+  }
+}
+
+void GDMaze::applyTilesFrame() { applyTiles(mFrameBudgetMs); }
+
+// Sets rows of tiles until the budget is used up (always at least one
+// row so it gets there in the end)
+void GDMaze::applyTiles(float budgetMs) {
+  TileMapLayer *pTileMap =
+      Object::cast_to<TileMapLayer>(ObjectDB::get_instance(mTileMapId));
+  if (!pTileMap) {
+    stopApplying();
+    return;
   }
 
-  // Smooth wells
-  if (mSmoothWalls) {
-    for (int ry = 0; ry < mRoomsTall; ++ry) {
-      for (int rx = 0; rx < mRoomsWide; ++rx) {
-        const Maze::Node *l_pNode = Maze::MazeHelper::findNode(pRoot, rx, ry);
-
-        // CHeck for removing vert nub. So must be open to the east
-        if ((rx != mRoomsWide - 1) && l_pNode->isOpen(2)) {
-          const Maze::Node *l_pNodeRight =
-              Maze::MazeHelper::findNode(pRoot, rx + 1, ry);
-          if (l_pNode->isClosed(0) && l_pNodeRight->isClosed(0)) {
-            Vector2i roomCorner = roomToCell(rx + 1, ry);
-            roomCorner.y += mWallHeight;
-            // if 2 north walls then remove the vert nub between them
-            for (int cy = 0; cy < (mRoomHeight - mDoorHeight) / 2; ++cy) {
-              for (int cx = 0; cx < mWallWidth; ++cx) {
-                Vector2i coords(roomCorner.x + cx, roomCorner.y + cy);
-                pTileMap->set_cell(coords, 0, mFloor);
-              }
-            }
-          }
-          if (l_pNode->isClosed(1) && l_pNodeRight->isClosed(1)) {
-            Vector2i roomCorner = roomToCell(rx + 1, ry);
-            roomCorner.y +=
-                mWallHeight + (mRoomHeight - (mRoomHeight - mDoorHeight) / 2);
-            // if 2 south walls then remove the vert nub between them
-            for (int cy = 0; cy < (mRoomHeight - mDoorHeight) / 2; ++cy) {
-              for (int cx = 0; cx < mWallWidth; ++cx) {
-                Vector2i coords(roomCorner.x + cx, roomCorner.y + cy);
-                pTileMap->set_cell(coords, 0, mFloor);
-              }
-            }
-          }
-        }
-
-        // CHeck for removing horz nub. So must be open to the south
-        if (ry != mRoomsTall - 1 && l_pNode->isOpen(1)) {
-          const Maze::Node *l_pNodeBelow =
-              Maze::MazeHelper::findNode(pRoot, rx, ry + 1);
-          if (l_pNode->isClosed(3) && l_pNodeBelow->isClosed(3)) {
-            Vector2i roomCorner = roomToCell(rx, ry + 1);
-            roomCorner.x += mWallWidth;
-            // if 2 west walls then remove the horz nub between them
-            for (int cy = 0; cy < mWallHeight; ++cy) {
-              for (int cx = 0; cx < (mRoomWidth - mDoorWidth) / 2; ++cx) {
-                Vector2i coords(roomCorner.x + cx, roomCorner.y + cy);
-                pTileMap->set_cell(coords, 0, mFloor);
-              }
-            }
-          }
-          if (l_pNode->isClosed(2) && l_pNodeBelow->isClosed(2)) {
-            Vector2i roomCorner = roomToCell(rx, ry + 1);
-            roomCorner.x +=
-                mWallWidth + (mRoomWidth - (mRoomWidth - mDoorWidth) / 2);
-            // if 2 east walls then remove the horz nub between them
-            for (int cy = 0; cy < mWallHeight; ++cy) {
-              for (int cx = 0; cx < (mRoomWidth - mDoorWidth) / 2; ++cx) {
-                Vector2i coords(roomCorner.x + cx, roomCorner.y + cy);
-                pTileMap->set_cell(coords, 0, mFloor);
-              }
-            }
-          }
-        }
+  const Clock::time_point l_start = Clock::now();
+  const std::chrono::duration<float, std::milli> l_budget(budgetMs);
+  const std::vector<unsigned char> &l_rTiles = mpJob->mTiles;
+  do {
+    const unsigned char *pRow = &l_rTiles[size_t(mAppliedRows) * mTilesWide];
+    for (int x = 0; x < mTilesWide; ++x) {
+      if (pRow[x] != Maze::Rasterizer::TILE_EMPTY) {
+        pTileMap->set_cell(Vector2i(x, mAppliedRows), 0,
+                           mAsyncAtlas[pRow[x]]);
       }
     }
+    ++mAppliedRows;
+  } while ((mAppliedRows < mTilesTall) && (Clock::now() - l_start < l_budget));
+
+  mProgress = 0.5f + 0.5f * mAppliedRows / mTilesTall;
+  if (mAppliedRows == mTilesTall) {
+    stopApplying();
+    emit_signal("maze_made");
+  }
+}
+
+void GDMaze::joinWorker() {
+  if (mWorker.joinable()) {
+    mWorker.join();
   }
-  delete pMaze;
+}
+
+void GDMaze::stopApplying() {
+  SceneTree *pTree = getSceneTree();
+  const Callable l_apply(this, "_apply_tiles_frame");
+  if (pTree && pTree->is_connected("process_frame", l_apply)) {
+    pTree->disconnect("process_frame", l_apply);
+  }
+  mpJob.reset();
+  mAsyncState = ASYNC_IDLE;
 }
 
 ///////////////////////////////////////////////////
 
-Vector2i GDMaze::roomToCell(int rx, int ry) {
-  int x = rx * (mRoomWidth + mWallWidth);
-  int y = ry * (mRoomHeight + mWallHeight);
-  return Vector2i(x, y);
+bool GDMaze::checkSizes() const {
+  if (mDoorWidth > mRoomWidth) {
+    ERR_PRINT("Door width must be <= Room width");
+    return false;
+  }
+  if (mDoorHeight > mRoomHeight) {
+    ERR_PRINT("Door height must be <= Room height");
+    return false;
+  }
+  return true;
+}
+
+Maze::Rasterizer GDMaze::makeRasterizer() const {
+  Maze::Rasterizer l_rasterizer;
+  l_rasterizer.setRoomSize(mRoomWidth, mRoomHeight);
+  l_rasterizer.setWallSize(mWallWidth, mWallHeight);
+  l_rasterizer.setDoorSize(mDoorWidth, mDoorHeight);
+  l_rasterizer.setSmoothWalls(mSmoothWalls);
+  return l_rasterizer;
 }
 
 ///////////////////////////////////////////////////
@@ -4,6 +4,16 @@
 #include <godot_cpp/classes/object.hpp>
 #include <godot_cpp/classes/tile_map_layer.hpp>
 
+#include <godot_cpp/variant/callable.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "Rasterizer.h"
+
 namespace godot {
 
 class GDMaze : public Object {
@@ -34,6 +44,32 @@ protected:
 	godot::Vector2i mFloor;
 	godot::Vector2i mWall;
 
+	// make_maze_async. The worker thread only touches the AsyncJob, which
+	// it shares, so cancelling just sets the job's cancel flag (which
+	// stops the generating part way) and forgets the job instead of
+	// waiting. The job number it passes to _on_tiles_ready says if it is
+	// still wanted. The worker is joined before starting the next one
+	// and when the GDMaze is freed, so none outlive it (or the library)
+	struct AsyncJob {
+		std::atomic<bool> mCancelled{false};
+		std::atomic<float> mProgress{0.0f};
+		std::vector<unsigned char> mTiles;
+		Callable mOnReady;
+	};
+	enum AsyncState { ASYNC_IDLE, ASYNC_GENERATING, ASYNC_APPLYING };
+	AsyncState mAsyncState = ASYNC_IDLE;
+	std::shared_ptr<AsyncJob> mpJob;
+	std::thread mWorker;
+	int mJobNumber = 0;
+	float mProgress = 0.0f;
+	float mFrameBudgetMs = 2.0f;
+
+	uint64_t mTileMapId = 0;
+	godot::Vector2i mAsyncAtlas[3];
+	int mTilesWide = 0;
+	int mTilesTall = 0;
+	int mAppliedRows = 0;
+
 public:
 	GDMaze();
 	~GDMaze();
@@ -55,10 +91,35 @@ public:
 	GDMaze* setFloor(godot::Vector2i floor);
 	GDMaze* setWall(godot::Vector2i wall);
 
+	// Generates the maze and sets its tiles on pTileMap.
+	// NOTE: This replaces the whole layer, not just the maze's rect:
+	//       anything already on it (even outside the maze, or inside its
+	//       rooms, which are left empty) is gone. It used to set only the
+	//       wall and floor tiles, leaving the rest of the layer as it was
 	void make_it(TileMapLayer* pTileMap, int layer, int seed);
 
+	// Generates and rasterizes on a worker thread, emits tiles_ready, then
+	// sets the tiles over as many frames as it takes to stay within the
+	// frame budget and emits maze_made. Returns false if already making one.
+	// Like make_it it clears the whole layer first (on tiles_ready)
+	bool make_it_async(TileMapLayer* pTileMap, int layer, int seed);
+	void cancel();
+	bool isBusy() const;
+	// 0..1 over the whole make_maze_async. Generating can't say how far
+	// it has got, so the first quarter jumps when it is done
+	float getProgress() const;
+	GDMaze* setFrameBudget(float ms);
+
+	// Called by make_maze_async, not for scripts
+	void onTilesReady(int job);
+	void applyTilesFrame();
+
 private:
-    godot::Vector2i roomToCell(int rx, int ry);
+	bool checkSizes() const;
+	Maze::Rasterizer makeRasterizer() const;
+	void applyTiles(float budgetMs);
+	void stopApplying();
+	void joinWorker();
 
 };
 
@@ -0,0 +1,806 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <vector>
+
+#include "BatchGenerator.h"
+#include "CellLoc.h"
+#include "ChunkedMaze.h"
+#include "DynamicMaze.h"
+#include "EllerGenerator.h"
+#include "GenerationStats.h"
+#include "Generator.h"
+#include "I_RowSink.h"
+#include "I_TileSink.h"
+#include "MazeData.h"
+#include "MazeFile.h"
+#include "MazeHelper.h"
+#include "Node.h"
+#include "PackedMaze.h"
+#include "ParallelGenerator.h"
+#include "PathOracle.h"
+#include "RandSimple.h"
+#include "Rasterizer.h"
+#include "Solver.h"
+#include "SquareGenerator.h"
+#include "ThreadPool.h"
+
+typedef std::chrono::steady_clock Clock;
+
+//
+// Count every heap allocation so can see how many a maze costs, and
+// the bytes live (and the most live) to see how much memory it needs.
+// Each block has its size in front of it (16 bytes to keep alignment).
+// Atomic since the batch and parallel benchmarks allocate on many
+// threads at once
+//
+static std::atomic<long> g_numAllocs(0);
+static std::atomic<long> g_liveBytes(0);
+static std::atomic<long> g_peakBytes(0);
+
+void *operator new(std::size_t size) {
+  ++g_numAllocs;
+  char *l_pMem = static_cast<char *>(std::malloc(size + 16));
+  if (not l_pMem) {
+    throw std::bad_alloc();
+  }
+  *reinterpret_cast<std::size_t *>(l_pMem) = size;
+  const long l_live = (g_liveBytes += size);
+  long l_peak = g_peakBytes.load();
+  while ((l_live > l_peak) and
+         not g_peakBytes.compare_exchange_weak(l_peak, l_live)) {
+  }
+  return l_pMem + 16;
+}
+void *operator new[](std::size_t size) { return operator new(size); }
+void operator delete(void *pMem) noexcept {
+  if (pMem) {
+    // The block starts 16 bytes before what new gave out. Work that out
+    // as an address, not by stepping back from pMem, so the compiler
+    // doesn't think it is outside whatever pMem was made for when this
+    // is inlined after a new (-Warray-bounds)
+    char *l_pMem = reinterpret_cast<char *>(
+        reinterpret_cast<std::uintptr_t>(pMem) - 16);
+    std::size_t l_size;
+    std::memcpy(&l_size, l_pMem, sizeof(l_size));
+    g_liveBytes -= l_size;
+    std::free(l_pMem);
+  }
+}
+void operator delete[](void *pMem) noexcept { operator delete(pMem); }
+void operator delete(void *pMem, std::size_t) noexcept {
+  operator delete(pMem);
+}
+void operator delete[](void *pMem, std::size_t) noexcept {
+  operator delete(pMem);
+}
+
+//
+// Neighbour enumeration as Generator::addNodeExits does it: add each
+// connection's change to the location and check it is in the maze.
+// The old CellLoc was a std::vector<int> => a heap allocation per probe
+//
+static std::vector<int> addVector(const std::vector<int> &rLHS,
+                                  const std::vector<int> &rRHS) {
+  std::vector<int> l_ret;
+  l_ret.reserve(rLHS.size());
+  for (unsigned int i = 0; i < rLHS.size(); ++i) {
+    l_ret.push_back(rLHS[i] + rRHS[i]);
+  }
+  return l_ret;
+}
+
+template <class LocT, class AddFn>
+static double timeNeighbours(int size, const LocT *pChanges, AddFn add,
+                             long *pValid) {
+  Clock::time_point l_start = Clock::now();
+  long l_valid = 0;
+  for (int y = 0; y < size; ++y) {
+    for (int x = 0; x < size; ++x) {
+      LocT l_loc = pChanges[4];
+      l_loc[0] = x;
+      l_loc[1] = y;
+      for (int c = 0; c < 4; ++c) {
+        LocT l_new = add(l_loc, pChanges[c]);
+        if (l_new[0] >= 0 and l_new[0] < size and l_new[1] >= 0 and
+            l_new[1] < size) {
+          ++l_valid;
+        }
+      }
+    }
+  }
+  *pValid = l_valid;
+  return std::chrono::duration<double, std::milli>(Clock::now() - l_start)
+      .count();
+}
+
+static void benchNeighbours(int size) {
+  const int l_changes[5][2] = {{0, -1}, {0, 1}, {1, 0}, {-1, 0}, {0, 0}};
+  std::vector<int> l_vecChanges[5];
+  Maze::CellLoc l_locChanges[5];
+  Maze::CellLoc2 l_loc2Changes[5];
+  for (int c = 0; c < 5; ++c) {
+    l_vecChanges[c].assign(l_changes[c], l_changes[c] + 2);
+    l_locChanges[c].assign(l_changes[c], l_changes[c] + 2);
+    l_loc2Changes[c] = Maze::CellLoc2{{l_changes[c][0], l_changes[c][1]}};
+  }
+
+  long l_valid[3];
+  double l_ms[3];
+  l_ms[0] = timeNeighbours(size, l_vecChanges, addVector, &l_valid[0]);
+  l_ms[1] = timeNeighbours(
+      size, l_locChanges,
+      [](const Maze::CellLoc &a, const Maze::CellLoc &b) { return a + b; },
+      &l_valid[1]);
+  l_ms[2] = timeNeighbours(
+      size, l_loc2Changes,
+      [](const Maze::CellLoc2 &a, const Maze::CellLoc2 &b) { return a + b; },
+      &l_valid[2]);
+
+  std::cout << "\nneighbours of " << size << "x" << size << " ("
+            << l_valid[0] << "/" << l_valid[1] << "/" << l_valid[2]
+            << " valid)\n"
+            << "std::vector<int> " << l_ms[0] << " ms\n"
+            << "CellLoc          " << l_ms[1] << " ms\n"
+            << "CellLoc2         " << l_ms[2] << " ms\n";
+}
+
+//
+// Generator making Nodes with the recursive backtracker (singlePath)
+// and with Kruskal. Both build the same Nodes first so the difference
+// is down to the maze algorithm, which is timed on its own as "maze"
+// (so a change to the backtracker can be compared before and after)
+//
+static void benchSinglePath(int size, unsigned int seed) {
+  std::cout << "\nnodes " << size << "x" << size
+            << "\nalgorithm     ms        maze ms   end\n";
+  for (int singlePath = 0; singlePath < 2; ++singlePath) {
+    Maze::TileData l_tileData;
+    Maze::MazeHelper::makeSquareTileData(l_tileData);
+    Maze::MazeData l_mazeData(l_tileData, Maze::CellLoc{size, size},
+                              Maze::CellLoc{0, 0}, false, singlePath);
+    Maze::Generator l_generator(l_mazeData);
+    Clock::time_point l_start = Clock::now();
+    Maze::MazeData *pMaze = l_generator.generate(seed);
+    const double ms =
+        std::chrono::duration<double, std::milli>(Clock::now() - l_start)
+            .count();
+    std::cout << (singlePath ? "singlePath\t" : "kruskal\t\t") << ms << "\t"
+              << pMaze->getStats().getPhaseMs(
+                     Maze::GenerationStats::PHASE_MAZE)
+              << "\t" << pMaze->getEndLoc() << "\n";
+    delete pMaze;
+  }
+}
+
+//
+// Each MazeData::Algorithm on the same square maze: how long it takes,
+// the most memory live while generating it and what fraction of the
+// cells are dead ends (a rough measure of how the maze looks)
+//
+static void benchAlgorithms(int size, unsigned int seed) {
+  const char *l_names[] = {"kruskal",     "eller",       "wilson",
+                           "prim",        "growingTree", "huntAndKill",
+                           "aldousBroder"};
+  std::cout << "\nalgorithms " << size << "x" << size
+            << "\nalgorithm       ms        peak MB   dead ends\n";
+  for (int a = Maze::MazeData::ALGO_DEFAULT;
+       a <= Maze::MazeData::ALGO_ALDOUS_BRODER; ++a) {
+    Maze::TileData l_tileData;
+    Maze::MazeHelper::makeSquareTileData(l_tileData);
+    Maze::MazeData l_mazeData(l_tileData, Maze::CellLoc{size, size},
+                              Maze::CellLoc{0, 0});
+    l_mazeData.setAlgorithm(Maze::MazeData::Algorithm(a));
+    Maze::Generator l_generator(l_mazeData);
+
+    const long l_startBytes = g_liveBytes;
+    g_peakBytes = g_liveBytes.load();
+    Clock::time_point l_start = Clock::now();
+    Maze::PackedMaze *pMaze = l_generator.generatePacked(seed);
+    const double ms =
+        std::chrono::duration<double, std::milli>(Clock::now() - l_start)
+            .count();
+    const double l_peakMB = (g_peakBytes - l_startBytes) / (1024.0 * 1024.0);
+
+    int l_deadEnds = 0;
+    for (int c = 0; c < pMaze->getNumCells(); ++c) {
+      const int l_mask = pMaze->getOpenMask(c);
+      l_deadEnds += (l_mask and not(l_mask & (l_mask - 1)));
+    }
+    std::cout << l_names[a] << (std::strlen(l_names[a]) < 8 ? "\t\t" : "\t")
+              << ms << "\t" << l_peakMB << "\t"
+              << double(l_deadEnds) / pMaze->getNumCells() << "\n";
+    delete pMaze;
+  }
+}
+
+//
+// Solver on a square maze: a distance field (as an AI flow field would
+// be refreshed every frame), one from several places at once, and A*
+// from the start to the end
+//
+static void benchSolver(int size, unsigned int seed) {
+  Maze::PackedMaze *pMaze = Maze::MazeHelper::generateSquarePackedMaze(
+      size, size, 0, 0, false, false, true, 5, seed);
+  const int l_numFrames = 100;
+
+  Clock::time_point l_start = Clock::now();
+  Maze::Solver l_solver(*pMaze);
+  Clock::time_point l_built = Clock::now();
+
+  std::vector<int> l_distances;
+  for (int f = 0; f < l_numFrames; ++f) {
+    l_solver.getDistances(f * (pMaze->getNumCells() / l_numFrames),
+                          l_distances);
+  }
+  Clock::time_point l_fields = Clock::now();
+
+  std::vector<int> l_sources;
+  for (int i = 0; i < 8; ++i) {
+    l_sources.push_back(i * (pMaze->getNumCells() / 8));
+  }
+  for (int f = 0; f < l_numFrames; ++f) {
+    l_solver.getDistances(l_sources, l_distances);
+  }
+  Clock::time_point l_multi = Clock::now();
+
+  const int l_startCell = pMaze->getCellIndex(pMaze->getStartLoc());
+  const int l_endCell = pMaze->getNumCells() - 1;
+  std::vector<int> l_path;
+  for (int f = 0; f < l_numFrames; ++f) {
+    l_solver.findPath(l_startCell, l_endCell, l_path);
+  }
+  Clock::time_point l_paths = Clock::now();
+
+  typedef std::chrono::duration<double, std::milli> Ms;
+  std::cout << "\nsolver " << size << "x" << size << "\nbuild "
+            << Ms(l_built - l_start).count() << " ms\ndistance field "
+            << Ms(l_fields - l_built).count() / l_numFrames
+            << " ms\n8 source field "
+            << Ms(l_multi - l_fields).count() / l_numFrames << " ms\nA* "
+            << l_path.size() << " cells "
+            << Ms(l_paths - l_multi).count() / l_numFrames << " ms\n";
+  delete pMaze;
+}
+
+//
+// PathOracle on a perfect maze: how long to build, then a lot of
+// distance and next step queries between random cells (as NPCs would
+// ask every tick) against one breadth first search for comparison
+//
+static void benchPathOracle(int size, unsigned int seed) {
+  Maze::PackedMaze *pMaze = Maze::MazeHelper::generateSquarePackedMaze(
+      size, size, 0, 0, false, true, false, 0, seed);
+  Maze::Solver l_solver(*pMaze);
+  const int l_numCells = pMaze->getNumCells();
+  const int l_numQueries = 1000000;
+
+  Clock::time_point l_start = Clock::now();
+  Maze::PathOracle l_oracle(l_solver, 0);
+  Clock::time_point l_built = Clock::now();
+
+  RNG::RandSimple l_rng(seed);
+  std::vector<int> l_cells(2 * l_numQueries);
+  for (unsigned int i = 0; i < l_cells.size(); ++i) {
+    l_cells[i] = (l_rng.getInt(0, 0x7fff) * 0x8000 + l_rng.getInt(0, 0x7fff)) %
+                 l_numCells;
+  }
+  Clock::time_point l_picked = Clock::now();
+  long l_total = 0;
+  for (int q = 0; q < l_numQueries; ++q) {
+    l_total += l_oracle.getDistance(l_cells[2 * q], l_cells[2 * q + 1]);
+  }
+  Clock::time_point l_distances = Clock::now();
+  for (int q = 0; q < l_numQueries; ++q) {
+    l_total += l_oracle.getNextCell(l_cells[2 * q], l_cells[2 * q + 1]);
+  }
+  Clock::time_point l_steps = Clock::now();
+
+  std::vector<int> l_bfs;
+  l_solver.getDistances(l_cells[0], l_bfs);
+  Clock::time_point l_searched = Clock::now();
+
+  typedef std::chrono::duration<double, std::milli> Ms;
+  std::cout << "\npath oracle " << size << "x" << size << "\nbuild "
+            << Ms(l_built - l_start).count() << " ms "
+            << l_oracle.getMemoryUsed() / double(l_numCells)
+            << " bytes/cell\ndistance "
+            << Ms(l_distances - l_picked).count() * 1e6 / l_numQueries
+            << " ns\nnext step "
+            << Ms(l_steps - l_distances).count() * 1e6 / l_numQueries
+            << " ns\none search " << Ms(l_searched - l_steps).count()
+            << " ms (" << l_total << ")\n";
+  delete pMaze;
+}
+
+//
+// DynamicMaze: close and reopen random exits (doors) in a maze with
+// loops, keeping the connectivity and a distance field up to date,
+// against making it all again. Cells looked at per change is the real
+// cost, which should have nothing to do with the size of the maze
+//
+static void benchDynamicMaze(int size, unsigned int seed) {
+  Maze::PackedMaze *pMaze = Maze::MazeHelper::generateSquarePackedMaze(
+      size, size, 0, 0, false, false, true, 5, seed);
+  const int l_numChanges = 10000;
+
+  Clock::time_point l_start = Clock::now();
+  Maze::DynamicMaze l_maze(*pMaze);
+  l_maze.addDistanceField(std::vector<int>(1, pMaze->getNumCells() / 2));
+  Clock::time_point l_built = Clock::now();
+
+  RNG::RandSimple l_rng(seed);
+  long l_numLooked = 0;
+  int l_numMade = 0;
+  for (int n = 0; n < l_numChanges; ++n) {
+    const int l_cell =
+        (l_rng.getInt(0, 0x7fff) * 0x8000 + l_rng.getInt(0, 0x7fff)) %
+        pMaze->getNumCells();
+    const int l_exit = l_rng.getInt(0, 3);
+    // Close it and open it again
+    for (int l_open = 0; l_open < 2; ++l_open) {
+      if (l_maze.setOpen(l_cell, l_exit, l_open)) {
+        l_numLooked += l_maze.getLastChangeSize();
+        ++l_numMade;
+      }
+    }
+  }
+  Clock::time_point l_changed = Clock::now();
+
+  typedef std::chrono::duration<double, std::milli> Ms;
+  std::cout << "\ndynamic maze " << size << "x" << size << "\nbuild "
+            << Ms(l_built - l_start).count() << " ms\nchange "
+            << Ms(l_changed - l_built).count() * 1000 / l_numMade
+            << " us (" << double(l_numLooked) / l_numMade
+            << " cells looked at)\n";
+  delete pMaze;
+}
+
+//
+// Generic Generator (Nodes then packed) against the SquareGenerator
+// fast path (checkMaze checks they make the same maze)
+//
+static void benchSquare(int size, bool singlePath, unsigned int seed) {
+  Maze::TileData l_tileData;
+  Maze::MazeHelper::makeSquareTileData(l_tileData);
+  Maze::MazeData l_mazeData(l_tileData, Maze::CellLoc{size, size},
+                            Maze::CellLoc{0, 0}, false, singlePath, true, 5);
+
+  RNG::RandSimple l_genericRNG(seed);
+  Clock::time_point l_start = Clock::now();
+  Maze::Generator l_generator(l_mazeData, &l_genericRNG);
+  Maze::MazeData *pNodes = l_generator.generate(seed);
+  Maze::PackedMaze *pGeneric = new Maze::PackedMaze(*pNodes);
+  delete pNodes;
+  Clock::time_point l_generic = Clock::now();
+
+  RNG::RandSimple l_squareRNG(seed);
+  Maze::SquareGenerator l_squareGenerator(l_mazeData, &l_squareRNG);
+  Maze::PackedMaze *pSquare = l_squareGenerator.generate(seed);
+  Clock::time_point l_square = Clock::now();
+
+  const double genericMs =
+      std::chrono::duration<double, std::milli>(l_generic - l_start).count();
+  const double squareMs =
+      std::chrono::duration<double, std::milli>(l_square - l_generic).count();
+  std::cout << "\nsquare " << size << "x" << size
+            << (singlePath ? " singlePath" : " kruskal")
+            << "\ngeneric " << genericMs << " ms\nsquare  " << squareMs
+            << " ms (x" << genericMs / squareMs << ")\n";
+  delete pGeneric;
+  delete pSquare;
+}
+
+//
+// Lots of mazes one at a time against BatchGenerator with more and
+// more threads
+//
+static void benchBatch(int size, int numMazes, unsigned int seed) {
+  Maze::TileData l_tileData;
+  Maze::MazeHelper::makeSquareTileData(l_tileData);
+  Maze::MazeData l_mazeData(l_tileData, Maze::CellLoc{size, size},
+                            Maze::CellLoc{0, 0}, false, false, true, 5);
+  Maze::BatchGenerator::JobList l_jobs;
+  for (int i = 0; i < numMazes; ++i) {
+    l_jobs.push_back(Maze::BatchGenerator::Job(l_mazeData, seed + i));
+  }
+
+  // One at a time, keeping the mazes until after the timing as the
+  // batches do
+  std::vector<Maze::MazeData *> l_seqResults;
+  Clock::time_point l_start = Clock::now();
+  RNG::RandSimple l_rng(1);
+  Maze::Generator l_generator(l_mazeData, &l_rng);
+  for (int i = 0; i < numMazes; ++i) {
+    l_seqResults.push_back(l_generator.generate(l_jobs[i].m_seed));
+  }
+  const double seqMs =
+      std::chrono::duration<double, std::milli>(Clock::now() - l_start)
+          .count();
+  for (int i = 0; i < numMazes; ++i) {
+    delete l_seqResults[i];
+  }
+  std::cout << "\nbatch of " << numMazes << " " << size << "x" << size
+            << "\nthreads   ms        speedup\nseq\t" << seqMs << "\n";
+
+  const int maxThreads = Maze::ThreadPool().getNumThreads();
+  for (int threads = 1; threads <= maxThreads; threads *= 2) {
+    Maze::BatchGenerator l_batch(threads);
+    std::vector<Maze::MazeData *> l_results;
+    l_start = Clock::now();
+    l_batch.generate(l_jobs, l_results);
+    const double batchMs =
+        std::chrono::duration<double, std::milli>(Clock::now() - l_start)
+            .count();
+
+    for (int i = 0; i < numMazes; ++i) {
+      delete l_results[i];
+    }
+    std::cout << threads << "\t" << batchMs << "\t" << seqMs / batchMs
+              << "\n";
+  }
+}
+
+//
+// One big maze: SquareGenerator on one core against ParallelGenerator
+// with more and more threads
+//
+static void benchParallel(int size, unsigned int seed) {
+  Maze::TileData l_tileData;
+  Maze::MazeHelper::makeSquareTileData(l_tileData);
+  Maze::MazeData l_mazeData(l_tileData, Maze::CellLoc{size, size},
+                            Maze::CellLoc{0, 0}, false, false, true, 5);
+
+  RNG::RandSimple l_rng(seed);
+  Clock::time_point l_start = Clock::now();
+  Maze::SquareGenerator l_squareGenerator(l_mazeData, &l_rng);
+  delete l_squareGenerator.generate(seed);
+  const double squareMs =
+      std::chrono::duration<double, std::milli>(Clock::now() - l_start)
+          .count();
+  std::cout << "\nparallel " << size << "x" << size
+            << "\nthreads   ms        speedup\nsquare\t" << squareMs << "\n";
+
+  const int maxThreads = Maze::ThreadPool().getNumThreads();
+  for (int threads = 1; threads <= maxThreads; threads *= 2) {
+    Maze::ParallelGenerator l_generator(l_mazeData, threads);
+    l_start = Clock::now();
+    Maze::PackedMaze *pMaze = l_generator.generate(seed);
+    const double parallelMs =
+        std::chrono::duration<double, std::milli>(Clock::now() - l_start)
+            .count();
+    std::cout << threads << "\t" << parallelMs << "\t"
+              << squareMs / parallelMs << "\n";
+    delete pMaze;
+  }
+}
+
+//
+// Walk a long way across a ChunkedMaze. Memory is fixed by the number
+// of chunks kept, however far the walk goes
+//
+static void benchChunked(int numSteps, unsigned int seed) {
+  Maze::TileData l_tileData;
+  Maze::MazeHelper::makeSquareTileData(l_tileData);
+  Maze::MazeData l_chunkData(l_tileData, Maze::CellLoc{64, 64},
+                             Maze::CellLoc{0, 0}, false, false, true, 5);
+  Maze::ChunkedMaze l_maze(l_chunkData, seed, 16);
+
+  // Diagonally, looking at a 3x3 block of chunks round the player
+  Clock::time_point l_start = Clock::now();
+  long l_numOpen = 0;
+  for (int step = 0; step < numSteps; ++step) {
+    const int x = step * 7;
+    const int y = step * 5;
+    for (int e = 0; e < Maze::SquareGenerator::NUM_EXITS; ++e) {
+      l_numOpen += l_maze.isOpen(x, y, e);
+    }
+    int l_chunkX, l_chunkY, l_localX, l_localY;
+    l_maze.getChunkLoc(x, y, &l_chunkX, &l_chunkY, &l_localX, &l_localY);
+    for (int dy = -1; dy <= 1; ++dy) {
+      for (int dx = -1; dx <= 1; ++dx) {
+        l_maze.getChunk(l_chunkX + dx, l_chunkY + dy);
+      }
+    }
+  }
+  const double ms =
+      std::chrono::duration<double, std::milli>(Clock::now() - l_start)
+          .count();
+  std::cout << "\nchunked walk of " << numSteps << " steps (64x64 chunks)\n"
+            << ms << " ms, " << l_maze.getNumGenerated() << " chunks made ("
+            << ms / l_maze.getNumGenerated() << " ms each), "
+            << l_maze.getNumResident() << " resident, " << l_numOpen
+            << " open\n";
+}
+
+//
+// Stream a very tall maze through Eller's a row at a time. The rows
+// are only counted, so the memory used is just the row storage
+//
+class CountRowSink : public Maze::I_RowSink {
+public:
+  CountRowSink() : m_numRows(0), m_numOpen(0) {}
+
+  virtual void addRow(int, const Maze::PackedMaze::ExitMask *pOpenMasks,
+                      int width) {
+    ++m_numRows;
+    for (int x = 0; x < width; ++x) {
+      for (int i = 0; i < Maze::SquareGenerator::NUM_EXITS; ++i) {
+        m_numOpen += (pOpenMasks[x] >> i) & 1;
+      }
+    }
+  }
+
+  long m_numRows;
+  long m_numOpen;
+};
+
+static void benchEller(int width, int numRows, unsigned int seed) {
+  Maze::TileData l_tileData;
+  Maze::MazeHelper::makeSquareTileData(l_tileData);
+  Maze::MazeData l_mazeData(l_tileData, Maze::CellLoc{width, numRows},
+                            Maze::CellLoc{0, 0}, false, false, true, 5);
+
+  RNG::RandSimple l_rng(seed);
+  Maze::EllerGenerator l_generator(l_mazeData, &l_rng);
+  CountRowSink l_sink;
+  const long l_startAllocs = g_numAllocs;
+  Clock::time_point l_start = Clock::now();
+  l_generator.generateRows(&l_sink, seed);
+  const double ms =
+      std::chrono::duration<double, std::milli>(Clock::now() - l_start)
+          .count();
+  const double cells = double(width) * numRows;
+  std::cout << "\neller " << width << "x" << numRows << " streamed\n"
+            << ms << " ms, " << (ms * 1e6 / cells) << " ns/cell, "
+            << l_sink.m_numRows << " rows, " << l_generator.getRowBytes()
+            << " bytes of rows (packed would be " << long(cells) * 2
+            << "), " << (g_numAllocs - l_startAllocs) << " allocs\n";
+}
+
+//
+// Saving a maze and opening it again against generating it. Reading
+// maps the file so should take about the same time whatever the size
+//
+static void benchMazeFile(int size, unsigned int seed) {
+  const char *pPath = "benchMaze.maze";
+  Clock::time_point l_start = Clock::now();
+  Maze::PackedMaze *pMaze = Maze::MazeHelper::generateSquarePackedMaze(
+      size, size, 0, 0, false, false, true, 5, seed);
+  Clock::time_point l_generated = Clock::now();
+  const bool written = Maze::MazeFile::write(*pMaze, pPath);
+  Clock::time_point l_written = Clock::now();
+  Maze::PackedMaze *pRead = Maze::MazeFile::read(pPath);
+  Clock::time_point l_read = Clock::now();
+  long l_numOpen = 0;
+  if (written and pRead) {
+    for (int c = 0; c < pRead->getNumCells(); ++c) {
+      l_numOpen += pRead->getOpenMask(c);
+    }
+  }
+  Clock::time_point l_scanned = Clock::now();
+
+  const double genMs =
+      std::chrono::duration<double, std::milli>(l_generated - l_start)
+          .count();
+  const double writeMs =
+      std::chrono::duration<double, std::milli>(l_written - l_generated)
+          .count();
+  const double readMs =
+      std::chrono::duration<double, std::milli>(l_read - l_written).count();
+  const double scanMs =
+      std::chrono::duration<double, std::milli>(l_scanned - l_read).count();
+  std::cout << "\nmaze file " << size << "x" << size << "\ngenerate "
+            << genMs << " ms, write " << writeMs << " ms, read " << readMs
+            << " ms, first scan " << scanMs << " ms (" << l_numOpen << ")\n";
+  delete pRead;
+  delete pMaze;
+  std::remove(pPath);
+}
+
+//
+// Tiles per second for different room sizes, into a flat buffer and into
+// a sink that only looks at the rows (how GDMaze and testMaze use it)
+//
+class CountTileSink : public Maze::I_TileSink {
+public:
+  CountTileSink() : m_numWalls(0) {}
+
+  void addRow(int, const unsigned char *pTiles, int width) override {
+    for (int x = 0; x < width; ++x) {
+      m_numWalls += (pTiles[x] == Maze::Rasterizer::TILE_WALL);
+    }
+  }
+
+  long m_numWalls;
+};
+
+static void benchRasterizer(int size, unsigned int seed) {
+  Maze::PackedMaze *pMaze = Maze::MazeHelper::generateSquarePackedMaze(
+      size, size, 0, 0, false, false, true, 0, seed);
+  const int l_sizes[][3] = {{1, 1, 1}, {3, 1, 1}, {8, 2, 2}, {16, 4, 6}};
+
+  std::cout << "\nrasterize " << size << "x" << size
+            << " rooms\nroom wall door  tiles      buffer Mtiles/s  "
+               "sink Mtiles/s\n";
+  for (const int *pSize : l_sizes) {
+    Maze::Rasterizer l_rasterizer;
+    l_rasterizer.setRoomSize(pSize[0], pSize[0]);
+    l_rasterizer.setWallSize(pSize[1], pSize[1]);
+    l_rasterizer.setDoorSize(pSize[2], pSize[2]);
+    std::vector<unsigned char> l_tiles(size_t(l_rasterizer.getWidth(size)) *
+                                       l_rasterizer.getHeight(size));
+
+    Clock::time_point l_start = Clock::now();
+    l_rasterizer.rasterize(*pMaze, l_tiles.data());
+    Clock::time_point l_buffered = Clock::now();
+    CountTileSink l_sink;
+    l_rasterizer.rasterize(*pMaze, l_sink);
+    Clock::time_point l_sunk = Clock::now();
+
+    const double bufferMs =
+        std::chrono::duration<double, std::milli>(l_buffered - l_start)
+            .count();
+    const double sinkMs =
+        std::chrono::duration<double, std::milli>(l_sunk - l_buffered)
+            .count();
+    const double tiles = double(l_tiles.size());
+    std::cout << pSize[0] << "\t" << pSize[1] << "\t" << pSize[2] << "\t"
+              << long(tiles) << "\t" << (tiles / bufferMs / 1e3) << "\t"
+              << (tiles / sinkMs / 1e3) << "\n";
+  }
+  delete pMaze;
+}
+
+//
+// noDeadEnds and openPlanChance are one sweep (see OpenPlan.h), the open
+// plan of a big maze in chunks that can go on a ThreadPool
+//
+static void benchOpenPlan(int size, unsigned int seed) {
+  Maze::TileData l_tileData;
+  Maze::MazeHelper::makeSquareTileData(l_tileData);
+  Maze::MazeData l_mazeData(l_tileData, Maze::CellLoc{size, size},
+                            Maze::CellLoc{0, 0}, false, false, true, 10);
+  Maze::ThreadPool l_pool;
+
+  std::cout << "\nopen plan " << size << "x" << size
+            << " noDeadEnds 10%\nthreads  deadEnds ms  openPlan ms\n";
+  for (int t = 0; t < 2; ++t) {
+    Maze::Generator l_generator(l_mazeData);
+    l_generator.setThreadPool(t ? &l_pool : 0);
+    Maze::MazeData *pMaze = l_generator.generate(seed);
+    const Maze::GenerationStats &l_rStats = pMaze->getStats();
+    std::cout << (t ? l_pool.getNumThreads() : 1) << "\t"
+              << l_rStats.getPhaseMs(Maze::GenerationStats::PHASE_DEAD_ENDS)
+              << "\t"
+              << l_rStats.getPhaseMs(Maze::GenerationStats::PHASE_OPEN_PLAN)
+              << "\n";
+    delete pMaze;
+  }
+}
+
+//
+// The RNG against a CounterRandom (see Generator::setCounterRandom),
+// packed with noDeadEnds and a 10% open plan, and the counter with a
+// pool
+//
+static void benchCounterRandom(int size, bool singlePath, unsigned int seed) {
+  Maze::TileData l_tileData;
+  Maze::MazeHelper::makeSquareTileData(l_tileData);
+  Maze::MazeData l_mazeData(l_tileData, Maze::CellLoc{size, size},
+                            Maze::CellLoc{0, 0}, false, singlePath, true, 10);
+  Maze::ThreadPool l_pool;
+  static const char *const NAMES[3] = {"rng    ", "counter", "counter pool"};
+
+  std::cout << "\ncounter random " << size << "x" << size
+            << (singlePath ? " singlePath" : " kruskal") << "\n";
+  Maze::PackedMaze *pMazes[3];
+  for (int m = 0; m < 3; ++m) {
+    Maze::Generator l_generator(l_mazeData);
+    l_generator.setCounterRandom(m > 0);
+    l_generator.setThreadPool((m == 2) ? &l_pool : 0);
+    Clock::time_point l_start = Clock::now();
+    pMazes[m] = l_generator.generatePacked(seed);
+    const double ms =
+        std::chrono::duration<double, std::milli>(Clock::now() - l_start)
+            .count();
+    std::cout << NAMES[m] << " " << ms << " ms\n";
+  }
+  for (int m = 0; m < 3; ++m) {
+    delete pMazes[m];
+  }
+}
+
+//
+// Times square maze generation for doubling sizes. With O(1) node
+// lookup the time per cell should stay roughly flat as the size grows.
+// The Nodes are in the MazeData's Arena so the number of allocations
+// per maze should stay flat too. Nothing is checked here, see checkMaze
+//
+// Usage: benchMaze [maxSize]   (default 4096)
+//
+int main(int argc, char *argv[]) {
+  const int maxSize = (argc > 1) ? std::atoi(argv[1]) : 4096;
+  const unsigned int seed = 12345;
+
+  std::cout << "size      cells      gen ms    del ms   ns/cell   allocs\n";
+  for (int size = 64; size <= maxSize; size *= 2) {
+    const long l_startAllocs = g_numAllocs;
+    Clock::time_point l_start = Clock::now();
+    Maze::MazeData *pMaze = Maze::MazeHelper::generateSquareMaze(
+        size, size, 0, 0, false, false, false, 0, seed);
+    Clock::time_point l_generated = Clock::now();
+    delete pMaze;
+    Clock::time_point l_deleted = Clock::now();
+
+    const double cells = double(size) * size;
+    const double genMs =
+        std::chrono::duration<double, std::milli>(l_generated - l_start)
+            .count();
+    const double delMs =
+        std::chrono::duration<double, std::milli>(l_deleted - l_generated)
+            .count();
+    std::cout << size << "x" << size << "\t" << long(cells) << "\t" << genMs
+              << "\t" << delMs << "\t" << (genMs * 1e6 / cells) << "\t"
+              << (g_numAllocs - l_startAllocs) << "\n";
+  }
+
+  //
+  // Same again but packed. The Node graph costs at least a Node plus
+  // an exit array per cell, the packed maze a few bytes per cell
+  //
+  std::cout << "\npacked    cells      gen ms    bytes/cell (Node >= "
+            << sizeof(Maze::Node) + 4 * sizeof(Maze::Node::Exit) << ")\n";
+  for (int size = 64; size <= maxSize; size *= 2) {
+    Clock::time_point l_start = Clock::now();
+    Maze::PackedMaze *pMaze = Maze::MazeHelper::generateSquarePackedMaze(
+        size, size, 0, 0, false, false, false, 0, seed);
+    Clock::time_point l_generated = Clock::now();
+
+    const double cells = double(size) * size;
+    const double genMs =
+        std::chrono::duration<double, std::milli>(l_generated - l_start)
+            .count();
+    std::cout << size << "x" << size << "\t" << long(cells) << "\t" << genMs
+              << "\t" << (pMaze->getMemoryUsed() / cells) << "\n";
+    delete pMaze;
+  }
+
+  benchNeighbours(maxSize < 1024 ? maxSize : 1024);
+
+  benchSinglePath(maxSize < 1024 ? maxSize : 1024, seed);
+
+  benchAlgorithms(maxSize < 512 ? maxSize : 512, seed);
+
+  benchSolver(maxSize < 256 ? maxSize : 256, seed);
+
+  benchPathOracle(maxSize < 1024 ? maxSize : 1024, seed);
+
+  benchDynamicMaze(maxSize < 1024 ? maxSize : 1024, seed);
+
+  benchSquare(maxSize < 2048 ? maxSize : 2048, false, seed);
+  benchSquare(maxSize < 2048 ? maxSize : 2048, true, seed);
+
+  benchBatch(maxSize < 256 ? maxSize : 256, 64, seed);
+
+  benchParallel(maxSize, seed);
+
+  benchChunked(2000, seed);
+
+  benchEller(1024, 100000, seed);
+
+  benchMazeFile(maxSize < 4096 ? maxSize : 4096, seed);
+
+  benchRasterizer(maxSize < 512 ? maxSize : 512, seed);
+
+  benchOpenPlan(maxSize < 2048 ? maxSize : 2048, seed);
+
+  benchCounterRandom(maxSize < 2048 ? maxSize : 2048, false, seed);
+  benchCounterRandom(maxSize < 2048 ? maxSize : 2048, true, seed);
+  return 0;
+}
@@ -0,0 +1,219 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "CellLoc.h"
+#include "GenerationStats.h"
+#include "Generator.h"
+#include "MazeData.h"
+#include "MazeHelper.h"
+#include "PackedMaze.h"
+#include "RandSimple.h"
+#include "Rasterizer.h"
+#include "TileData.h"
+
+typedef std::chrono::steady_clock Clock;
+
+//
+// Phases timed here on top of the GenerationStats ones
+//
+enum ExtraPhase { EXTRA_DELETE = 0, EXTRA_PACK, EXTRA_RASTERIZE, NUM_EXTRA };
+static const char *const EXTRA_NAMES[NUM_EXTRA] = {"delete", "pack",
+                                                   "rasterize"};
+
+static void addConnection(Maze::TileData &rTileData, Maze::CellType from,
+                          Maze::CellType to, const Maze::CellLoc &rChange) {
+  Maze::TileData::Connection l_con;
+  l_con.fromCellType = from;
+  l_con.toCellType = to;
+  l_con.locChange = rChange;
+  rTileData.defineConnection(l_con);
+}
+
+//
+// The tile types to try, each with dimensions giving about size x size
+// cells
+//
+struct TileCase {
+  std::string m_name;
+  Maze::TileData m_tileData;
+  bool m_square;
+};
+
+static std::vector<TileCase> makeTileCases() {
+  std::vector<TileCase> l_cases(3);
+
+  l_cases[0].m_name = "square";
+  Maze::MazeHelper::makeSquareTileData(l_cases[0].m_tileData);
+  l_cases[0].m_square = true;
+
+  // Two cell types alternating along the rows (needs an even width)
+  l_cases[1].m_name = "twoType";
+  Maze::TileData &rTwo = l_cases[1].m_tileData;
+  addConnection(rTwo, 0, 1, Maze::CellLoc{1, 0});
+  addConnection(rTwo, 0, 1, Maze::CellLoc{-1, 0});
+  addConnection(rTwo, 0, 0, Maze::CellLoc{0, 1});
+  addConnection(rTwo, 0, 0, Maze::CellLoc{0, -1});
+  addConnection(rTwo, 1, 1, Maze::CellLoc{0, 1});
+  addConnection(rTwo, 1, 0, Maze::CellLoc{1, 0});
+  addConnection(rTwo, 1, 0, Maze::CellLoc{-1, 0});
+  addConnection(rTwo, 1, 1, Maze::CellLoc{0, -1});
+  l_cases[1].m_square = false;
+
+  l_cases[2].m_name = "cube";
+  Maze::TileData &rCube = l_cases[2].m_tileData;
+  addConnection(rCube, 0, 0, Maze::CellLoc{1, 0, 0});
+  addConnection(rCube, 0, 0, Maze::CellLoc{-1, 0, 0});
+  addConnection(rCube, 0, 0, Maze::CellLoc{0, 1, 0});
+  addConnection(rCube, 0, 0, Maze::CellLoc{0, -1, 0});
+  addConnection(rCube, 0, 0, Maze::CellLoc{0, 0, 1});
+  addConnection(rCube, 0, 0, Maze::CellLoc{0, 0, -1});
+  l_cases[2].m_square = false;
+  return l_cases;
+}
+
+static Maze::CellLoc makeDimensions(const TileCase &rCase, int size) {
+  if (rCase.m_name == "cube") {
+    const int l_side = int(std::cbrt(double(size) * size) + 0.5);
+    return Maze::CellLoc{l_side, l_side, l_side};
+  }
+  return Maze::CellLoc{size, size};
+}
+
+static double msSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start)
+      .count();
+}
+
+//
+// Generates the maze repeats times keeping the fastest time of each
+// phase, and writes them as a JSON object
+//
+static void benchCase(const TileCase &rCase, int size, bool wrap,
+                      bool singlePath, bool noDeadEnds, int openPlanChance,
+                      int repeats, unsigned int seed, bool first) {
+  const Maze::CellLoc l_dimensions = makeDimensions(rCase, size);
+  Maze::MazeData l_mazeData(rCase.m_tileData, l_dimensions,
+                            Maze::CellLoc(l_dimensions.size(), 0), wrap,
+                            singlePath, noDeadEnds, openPlanChance);
+
+  double l_phaseMs[Maze::GenerationStats::NUM_PHASES];
+  double l_extraMs[NUM_EXTRA];
+  Maze::GenerationStats l_stats;
+  for (int r = 0; r < repeats; ++r) {
+    RNG::RandSimple l_rng(seed);
+    Maze::Generator l_generator(l_mazeData, &l_rng);
+    Maze::MazeData *pMaze = l_generator.generate(seed);
+    double l_runExtraMs[NUM_EXTRA] = {0.0, 0.0, 0.0};
+
+    if (rCase.m_square) {
+      Clock::time_point l_start = Clock::now();
+      Maze::PackedMaze l_packed(*pMaze);
+      l_runExtraMs[EXTRA_PACK] = msSince(l_start);
+
+      Maze::Rasterizer l_rasterizer;
+      std::vector<unsigned char> l_tiles(
+          size_t(l_rasterizer.getWidth(l_dimensions[0])) *
+          l_rasterizer.getHeight(l_dimensions[1]));
+      l_start = Clock::now();
+      l_rasterizer.rasterize(l_packed, l_tiles.data());
+      l_runExtraMs[EXTRA_RASTERIZE] = msSince(l_start);
+    }
+
+    for (int i = 0; i < Maze::GenerationStats::NUM_PHASES; ++i) {
+      const double ms = pMaze->getStats().getPhaseMs(
+          Maze::GenerationStats::Phase(i));
+      l_phaseMs[i] = (r == 0) ? ms : std::min(l_phaseMs[i], ms);
+    }
+    // Same counts each time
+    l_stats = pMaze->getStats();
+
+    // The Nodes are in the MazeData's Arena so go with it
+    Clock::time_point l_start = Clock::now();
+    delete pMaze;
+    l_runExtraMs[EXTRA_DELETE] = msSince(l_start);
+    for (int i = 0; i < NUM_EXTRA; ++i) {
+      l_extraMs[i] =
+          (r == 0) ? l_runExtraMs[i] : std::min(l_extraMs[i], l_runExtraMs[i]);
+    }
+  }
+
+  std::cout << (first ? "\n" : ",\n") << "    {\"tiles\": \"" << rCase.m_name
+            << "\", \"dims\": [";
+  for (unsigned int i = 0; i < l_dimensions.size(); ++i) {
+    std::cout << (i ? ", " : "") << l_dimensions[i];
+  }
+  std::cout << "], \"cells\": " << l_mazeData.getTotalCells()
+            << ", \"wrapRound\": " << (wrap ? "true" : "false")
+            << ", \"singlePath\": " << (singlePath ? "true" : "false")
+            << ", \"noDeadEnds\": " << (noDeadEnds ? "true" : "false")
+            << ", \"openPlanChance\": " << openPlanChance
+            << ",\n     \"ms\": {";
+  for (int i = 0; i < Maze::GenerationStats::NUM_PHASES; ++i) {
+    const Maze::GenerationStats::Phase l_phase =
+        Maze::GenerationStats::Phase(i);
+    std::cout << (i ? ", \"" : "\"")
+              << Maze::GenerationStats::getPhaseName(l_phase) << "\": ";
+    // null rather than 0 when timed as part of another phase
+    if (l_stats.isPhaseFused(l_phase)) {
+      std::cout << "null";
+    } else {
+      std::cout << l_phaseMs[i];
+    }
+  }
+  for (int i = 0; i < NUM_EXTRA; ++i) {
+    if (rCase.m_square or (i == EXTRA_DELETE)) {
+      std::cout << ", \"" << EXTRA_NAMES[i] << "\": " << l_extraMs[i];
+    }
+  }
+  std::cout << "},\n     \"counts\": {";
+  for (int i = 0; i < Maze::GenerationStats::NUM_COUNTS; ++i) {
+    const Maze::GenerationStats::Count l_count =
+        Maze::GenerationStats::Count(i);
+    std::cout << (i ? ", \"" : "\"")
+              << Maze::GenerationStats::getCountName(l_count)
+              << "\": " << l_stats.getCount(l_count);
+  }
+  std::cout << "}}";
+}
+
+//
+// Times each phase of generating (see GenerationStats), deleting and
+// rasterizing, with the counts of what was made, for doubling sizes,
+// every tile type and every combination of wrapRound, singlePath,
+// noDeadEnds and openPlanChance 0/10. Prints JSON so runs can be saved
+// and compared e.g.
+//   maze_bench 512 > before.json
+//
+// Usage: maze_bench [maxSize] [repeats]   (default 256 3)
+//
+int main(int argc, char *argv[]) {
+  const int maxSize = (argc > 1) ? std::atoi(argv[1]) : 256;
+  const int repeats = (argc > 2) ? std::atoi(argv[2]) : 3;
+  if (repeats < 1) {
+    // Nothing would be timed, so there would be no fastest time to print
+    std::cerr << "Usage: maze_bench [maxSize] [repeats]   (repeats >= 1)\n";
+    return 1;
+  }
+  const unsigned int seed = 12345;
+  const std::vector<TileCase> l_cases = makeTileCases();
+
+  std::cout << "{\n  \"seed\": " << seed << ",\n  \"repeats\": " << repeats
+            << ",\n  \"runs\": [";
+  bool first = true;
+  for (int size = 64; size <= maxSize; size *= 2) {
+    for (unsigned int c = 0; c < l_cases.size(); ++c) {
+      for (int mode = 0; mode < 16; ++mode) {
+        benchCase(l_cases[c], size, mode & 1, mode & 2, mode & 4,
+                  (mode & 8) ? 10 : 0, repeats, seed, first);
+        first = false;
+      }
+    }
+  }
+  std::cout << "\n  ]\n}\n";
+  return 0;
+}
@@ -0,0 +1,977 @@
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "BatchGenerator.h"
+#include "CellLoc.h"
+#include "ChunkedMaze.h"
+#include "DynamicMaze.h"
+#include "Generator.h"
+#include "I_RowSink.h"
+#include "MazeData.h"
+#include "MazeFile.h"
+#include "MazeHelper.h"
+#include "Node.h"
+#include "PackedMaze.h"
+#include "ParallelGenerator.h"
+#include "PathOracle.h"
+#include "RandSimple.h"
+#include "Rasterizer.h"
+#include "Solver.h"
+#include "SquareGenerator.h"
+#include "ThreadPool.h"
+#include "TileData.h"
+
+//
+// Checks that the optimised code gives the same answers as doing it
+// the simple way. Each check says what failed, and main returns
+// non-zero if any did, so ctest fails.
+//
+// The timings are in benchMaze, which doesn't check anything (it runs
+// the same code on bigger mazes).
+//
+
+static int g_numFailed = 0;
+
+static void expect(bool ok, const char *pWhat) {
+  if (not ok) {
+    std::cerr << "FAILED: " << pWhat << "\n";
+    ++g_numFailed;
+  }
+}
+
+// Keeps the open masks of the rows it is given
+class RowsSink : public Maze::I_RowSink {
+public:
+  explicit RowsSink(int numCells) : m_numRows(0), m_openMasks(numCells, 0) {}
+
+  void addRow(int y, const Maze::PackedMaze::ExitMask *pOpenMasks,
+              int width) override {
+    ++m_numRows;
+    std::memcpy(&m_openMasks[size_t(y) * width], pOpenMasks, width);
+  }
+
+  int m_numRows;
+  std::vector<Maze::PackedMaze::ExitMask> m_openMasks;
+};
+
+static bool samePacked(const Maze::PackedMaze &rLHS,
+                       const Maze::PackedMaze &rRHS) {
+  const int cells = rLHS.getNumCells();
+  return (cells == rRHS.getNumCells()) and
+         (0 == std::memcmp(rLHS.getOpenMasks(), rRHS.getOpenMasks(),
+                           cells)) and
+         (0 == std::memcmp(rLHS.getUpTreeMasks(), rRHS.getUpTreeMasks(),
+                           cells));
+}
+
+//
+// A* must find a path as short as the distance field says it is
+//
+static void checkSolver(int size, unsigned int seed) {
+  Maze::PackedMaze *pMaze = Maze::MazeHelper::generateSquarePackedMaze(
+      size, size, 0, 0, false, false, true, 5, seed);
+  Maze::Solver l_solver(*pMaze);
+  const int l_startCell = pMaze->getCellIndex(pMaze->getStartLoc());
+  const int l_endCell = pMaze->getNumCells() - 1;
+  std::vector<int> l_path;
+  l_solver.findPath(l_startCell, l_endCell, l_path);
+  std::vector<int> l_distances;
+  l_solver.getDistances(l_endCell, l_distances);
+  expect(int(l_path.size()) == l_distances[l_startCell] + 1,
+         "Solver A* path differs from the distance field");
+  delete pMaze;
+}
+
+//
+// PathOracle distances on a perfect maze must match a breadth first
+// search, and each next step must be one nearer
+//
+static void checkPathOracle(int size, unsigned int seed) {
+  Maze::PackedMaze *pMaze = Maze::MazeHelper::generateSquarePackedMaze(
+      size, size, 0, 0, false, true, false, 0, seed);
+  Maze::Solver l_solver(*pMaze);
+  Maze::PathOracle l_oracle(l_solver, 0);
+  RNG::RandSimple l_rng(seed);
+  bool l_same = l_oracle.isPerfect();
+  std::vector<int> l_bfs;
+  for (int s = 0; s < 4; ++s) {
+    const int l_from = l_rng.getInt(0, pMaze->getNumCells() - 1);
+    l_solver.getDistances(l_from, l_bfs);
+    for (int c = 0; c < pMaze->getNumCells(); ++c) {
+      l_same = l_same and (l_oracle.getDistance(l_from, c) == l_bfs[c]);
+      if (c != l_from) {
+        l_same = l_same and
+                 (l_bfs[l_oracle.getNextCell(c, l_from)] == l_bfs[c] - 1);
+      }
+    }
+  }
+  expect(l_same, "PathOracle differs from a breadth first search");
+  delete pMaze;
+}
+
+//
+// The SquareGenerator fast path must make the maze the generic
+// Generator does (Nodes then packed)
+//
+static void checkSquare(int size, bool singlePath, unsigned int seed) {
+  Maze::TileData l_tileData;
+  Maze::MazeHelper::makeSquareTileData(l_tileData);
+  Maze::MazeData l_mazeData(l_tileData, Maze::CellLoc{size, size},
+                            Maze::CellLoc{0, 0}, false, singlePath, true, 5);
+
+  RNG::RandSimple l_genericRNG(seed);
+  Maze::Generator l_generator(l_mazeData, &l_genericRNG);
+  Maze::MazeData *pNodes = l_generator.generate(seed);
+  Maze::PackedMaze l_generic(*pNodes);
+  delete pNodes;
+
+  RNG::RandSimple l_squareRNG(seed);
+  Maze::SquareGenerator l_squareGenerator(l_mazeData, &l_squareRNG);
+  Maze::PackedMaze *pSquare = l_squareGenerator.generate(seed);
+  expect(samePacked(l_generic, *pSquare) and
+             (l_generic.getEndLoc() == pSquare->getEndLoc()),
+         singlePath ? "SquareGenerator singlePath differs from Generator"
+                    : "SquareGenerator differs from Generator");
+  delete pSquare;
+}
+
+//
+// Eller's must make a perfect maze (every cell reached from the first,
+// with one passage fewer than cells), and generateRows must give the
+// rows generatePacked packs for the same seed
+//
+static void checkEller(int width, int height, unsigned int seed) {
+  Maze::TileData l_tileData;
+  Maze::MazeHelper::makeSquareTileData(l_tileData);
+  Maze::MazeData l_mazeData(l_tileData, Maze::CellLoc{width, height},
+                            Maze::CellLoc{0, 0}, false, false, false, 0);
+  l_mazeData.setAlgorithm(Maze::MazeData::ALGO_ELLER);
+  Maze::Generator l_generator(l_mazeData);
+  Maze::PackedMaze *pMaze = l_generator.generatePacked(seed);
+
+  // N, S, E, W as SquareGenerator
+  const int DX[4] = {0, 0, 1, -1};
+  const int DY[4] = {-1, 1, 0, 0};
+  const int l_numCells = width * height;
+  std::vector<char> l_reached(l_numCells, 0);
+  std::vector<int> l_todo(1, 0);
+  l_reached[0] = 1;
+  int l_numReached = 1;
+  long l_numOpenExits = 0;
+  while (not l_todo.empty()) {
+    const int l_cell = l_todo.back();
+    l_todo.pop_back();
+    for (int i = 0; i < 4; ++i) {
+      if (not pMaze->isOpen(l_cell, i)) {
+        continue;
+      }
+      ++l_numOpenExits;
+      const int x = l_cell % width + DX[i];
+      const int y = l_cell / width + DY[i];
+      if ((x < 0) or (x >= width) or (y < 0) or (y >= height)) {
+        // Never wraps
+        l_numOpenExits = -l_numCells;
+        continue;
+      }
+      const int l_next = y * width + x;
+      if (not l_reached[l_next]) {
+        l_reached[l_next] = 1;
+        ++l_numReached;
+        l_todo.push_back(l_next);
+      }
+    }
+  }
+  expect((l_numReached == l_numCells) and
+             (l_numOpenExits == 2L * (l_numCells - 1)),
+         "Eller's maze isn't perfect");
+
+  RowsSink l_sink(l_numCells);
+  l_generator.generateRows(&l_sink, seed);
+  bool l_same = (l_sink.m_numRows == height);
+  for (int c = 0; c < l_numCells; ++c) {
+    l_same = l_same and (l_sink.m_openMasks[c] == pMaze->getOpenMask(c));
+  }
+  expect(l_same, "Eller's generateRows differs from generatePacked");
+  delete pMaze;
+}
+
+//
+// Every maze BatchGenerator makes must match the one made on its own,
+// whatever the number of threads
+//
+static void checkBatch(int size, int numMazes, unsigned int seed) {
+  Maze::TileData l_tileData;
+  Maze::MazeHelper::makeSquareTileData(l_tileData);
+  Maze::MazeData l_mazeData(l_tileData, Maze::CellLoc{size, size},
+                            Maze::CellLoc{0, 0}, false, false, true, 5);
+  Maze::BatchGenerator::JobList l_jobs;
+  for (int i = 0; i < numMazes; ++i) {
+    l_jobs.push_back(Maze::BatchGenerator::Job(l_mazeData, seed + i));
+  }
+
+  std::vector<Maze::PackedMaze *> l_expected;
+  RNG::RandSimple l_rng(1);
+  Maze::Generator l_generator(l_mazeData, &l_rng);
+  for (int i = 0; i < numMazes; ++i) {
+    Maze::MazeData *pMaze = l_generator.generate(l_jobs[i].m_seed);
+    l_expected.push_back(new Maze::PackedMaze(*pMaze));
+    delete pMaze;
+  }
+
+  const int maxThreads = Maze::ThreadPool().getNumThreads();
+  for (int threads = 1; threads <= maxThreads; threads *= 2) {
+    Maze::BatchGenerator l_batch(threads);
+    std::vector<Maze::MazeData *> l_results;
+    l_batch.generate(l_jobs, l_results);
+    bool l_same = (int(l_results.size()) == numMazes);
+    for (unsigned int i = 0; i < l_results.size(); ++i) {
+      Maze::PackedMaze l_packed(*l_results[i]);
+      l_same = l_same and samePacked(l_packed, *l_expected[i]);
+      delete l_results[i];
+    }
+    expect(l_same, "BatchGenerator maze differs from one made on its own");
+  }
+  for (int i = 0; i < numMazes; ++i) {
+    delete l_expected[i];
+  }
+}
+
+//
+// ParallelGenerator makes a different maze to SquareGenerator, but it
+// must be the same for every number of threads
+//
+static void checkParallel(int size, unsigned int seed) {
+  Maze::TileData l_tileData;
+  Maze::MazeHelper::makeSquareTileData(l_tileData);
+  Maze::MazeData l_mazeData(l_tileData, Maze::CellLoc{size, size},
+                            Maze::CellLoc{0, 0}, false, false, true, 5);
+
+  Maze::PackedMaze *pFirst = 0;
+  const int maxThreads = Maze::ThreadPool().getNumThreads();
+  for (int threads = 1; threads <= maxThreads; threads *= 2) {
+    Maze::ParallelGenerator l_generator(l_mazeData, threads);
+    Maze::PackedMaze *pMaze = l_generator.generate(seed);
+    if (not pFirst) {
+      pFirst = pMaze;
+      continue;
+    }
+    expect(samePacked(*pFirst, *pMaze),
+           "ParallelGenerator maze depends on the number of threads");
+    delete pMaze;
+  }
+  delete pFirst;
+}
+
+//
+// A maze written and read back must be the one written
+//
+static void checkMazeFile(int size, unsigned int seed) {
+  const char *pPath = "checkMazeFile.maze";
+  Maze::PackedMaze *pMaze = Maze::MazeHelper::generateSquarePackedMaze(
+      size, size, 0, 0, false, false, true, 5, seed);
+  const bool written = Maze::MazeFile::write(*pMaze, pPath);
+  Maze::PackedMaze *pRead = Maze::MazeFile::read(pPath);
+  expect(written and pRead and samePacked(*pMaze, *pRead) and
+             (pMaze->getStartLoc() == pRead->getStartLoc()) and
+             (pMaze->getEndLoc() == pRead->getEndLoc()),
+         "MazeFile round trip differs");
+  delete pRead;
+  delete pMaze;
+  std::remove(pPath);
+}
+
+//
+// The open plan sweep (see OpenPlan.h) makes the same maze with and
+// without a ThreadPool, and so does a CounterRandom (see
+// Generator::setCounterRandom) for everything else
+//
+static void checkThreadPool(int size, bool singlePath, unsigned int seed) {
+  Maze::TileData l_tileData;
+  Maze::MazeHelper::makeSquareTileData(l_tileData);
+  Maze::MazeData l_mazeData(l_tileData, Maze::CellLoc{size, size},
+                            Maze::CellLoc{0, 0}, false, singlePath, true, 10);
+  Maze::ThreadPool l_pool;
+  for (int counter = 0; counter < 2; ++counter) {
+    Maze::PackedMaze *pMazes[2];
+    for (int m = 0; m < 2; ++m) {
+      Maze::Generator l_generator(l_mazeData);
+      l_generator.setCounterRandom(counter);
+      l_generator.setThreadPool(m ? &l_pool : 0);
+      pMazes[m] = l_generator.generatePacked(seed);
+    }
+    expect(samePacked(*pMazes[0], *pMazes[1]),
+           counter ? "CounterRandom maze differs with a ThreadPool"
+                   : "open plan maze differs with a ThreadPool");
+    delete pMazes[0];
+    delete pMazes[1];
+  }
+}
+
+//
+// The compiled TileData lookups (see TileData::compile) give no reverse
+// Connection instead of reading the tables when not compiled
+//
+static void checkTileDataCompiled() {
+  Maze::TileData l_tileData;
+  Maze::MazeHelper::makeSquareTileData(l_tileData);
+  bool l_ok = (l_tileData.getReverseConnection(0, 0) == -1);
+  l_tileData.compile(Maze::CellLoc{8, 8});
+  l_ok = l_ok and (l_tileData.getReverseConnection(0, 0) == 1) and
+         (l_tileData.getIndexDelta(0, 1) == 8) and
+         (l_tileData.getReverseConnection(0, 4) == -1);
+  Maze::TileData::Connection l_con = l_tileData.getDefinedConnection(0);
+  l_con.fromCellType = 1;
+  l_tileData.defineConnection(l_con);
+  l_ok = l_ok and (l_tileData.getReverseConnection(0, 0) == -1);
+  expect(l_ok, "TileData lookups when not compiled");
+}
+
+//
+// A cancel flag that isn't set gives the same maze as none, one that
+// is gives no maze
+//
+static void checkCancel(int size, unsigned int seed) {
+  std::atomic<bool> l_cancelled(false);
+  Maze::PackedMaze *pMaze = Maze::MazeHelper::generateSquarePackedMaze(
+      size, size, 0, 0, false, false, true, 10, seed);
+  Maze::PackedMaze *pNotCancelled = Maze::MazeHelper::generateSquarePackedMaze(
+      size, size, 0, 0, false, false, true, 10, seed, &l_cancelled);
+  expect(pNotCancelled and samePacked(*pMaze, *pNotCancelled),
+         "maze differs with a cancel flag");
+  delete pMaze;
+  delete pNotCancelled;
+
+  l_cancelled = true;
+  for (int singlePath = 0; singlePath < 2; ++singlePath) {
+    expect(not Maze::MazeHelper::generateSquarePackedMaze(
+               size, size, 0, 0, false, singlePath, true, 10, seed,
+               &l_cancelled),
+           "cancelled square maze generated");
+  }
+  Maze::TileData l_tileData;
+  Maze::MazeHelper::makeSquareTileData(l_tileData);
+  Maze::MazeData l_mazeData(l_tileData, Maze::CellLoc{size, size},
+                            Maze::CellLoc{0, 0}, false, false, false, 0);
+  l_mazeData.setAlgorithm(Maze::MazeData::ALGO_PRIM);
+  Maze::Generator l_generator(l_mazeData);
+  l_generator.setCancelFlag(&l_cancelled);
+  expect(not l_generator.generatePacked(seed), "cancelled maze generated");
+
+  // And no rows for generateRows, however it makes them
+  const Maze::MazeData::Algorithm l_algorithms[] = {
+      Maze::MazeData::ALGO_DEFAULT, Maze::MazeData::ALGO_ELLER,
+      Maze::MazeData::ALGO_PRIM};
+  for (int a = 0; a < 3; ++a) {
+    l_mazeData.setAlgorithm(l_algorithms[a]);
+    l_generator.setMazeData(l_mazeData);
+    RowsSink l_sink(size * size);
+    l_generator.generateRows(&l_sink, seed);
+    expect(0 == l_sink.m_numRows, "cancelled generateRows gave rows");
+  }
+}
+
+//
+// The node index Generator hands to the MazeData must have every Node
+// of the tree at its location, as building it from the tree does
+//
+static void checkFindNode(int size, unsigned int seed) {
+  Maze::MazeData *pMaze = Maze::MazeHelper::generateSquareMaze(
+      size, size, 0, 0, false, false, false, 0, seed);
+  Maze::MazeHelper::NodeList l_allNodes;
+  Maze::MazeHelper::makeNodeList(pMaze->getRoot(), l_allNodes);
+  bool l_same = (int(l_allNodes.size()) == size * size);
+  for (unsigned int i = 0; i < l_allNodes.size(); ++i) {
+    l_same = l_same and (Maze::MazeHelper::findNode(
+                             *pMaze, l_allNodes[i]->getCellLoc()) ==
+                         l_allNodes[i]);
+  }
+  std::vector<const Maze::Node *> l_handed;
+  for (int y = 0; y < size; ++y) {
+    for (int x = 0; x < size; ++x) {
+      l_handed.push_back(Maze::MazeHelper::findNode(*pMaze, x, y));
+    }
+  }
+  pMaze->buildNodeIndex();
+  for (int y = 0; y < size; ++y) {
+    for (int x = 0; x < size; ++x) {
+      l_same = l_same and
+               (Maze::MazeHelper::findNode(*pMaze, x, y) ==
+                l_handed[y * size + x]);
+    }
+  }
+  l_same = l_same and not Maze::MazeHelper::findNode(*pMaze, size, 0);
+  delete pMaze;
+  expect(l_same, "Generator's node index differs from the tree");
+}
+
+//
+// Breadth first search over the DynamicMaze's open exits from the cell
+// not already found, into rQueue. Exits that lead out of the maze (-1,
+// ChunkedMaze doors) are skipped. Returns false if the component it
+// keeps doesn't match (each search inside one component the same size
+// => the same parts)
+//
+static bool searchComponent(const Maze::DynamicMaze &rMaze, int from,
+                            std::vector<int> &rFound,
+                            std::vector<int> &rDistances,
+                            std::vector<int> &rQueue) {
+  rQueue.assign(1, from);
+  rFound[from] = from;
+  rDistances[from] = 0;
+  for (unsigned int i = 0; i < rQueue.size(); ++i) {
+    const int l_cell = rQueue[i];
+    for (int e = 0; e < Maze::SquareGenerator::NUM_EXITS; ++e) {
+      const int l_next = rMaze.getExitCell(l_cell, e);
+      if ((l_next >= 0) and rMaze.isOpen(l_cell, e) and
+          (rFound[l_next] < 0)) {
+        rFound[l_next] = from;
+        rDistances[l_next] = rDistances[l_cell] + 1;
+        rQueue.push_back(l_next);
+      }
+    }
+  }
+  bool l_same = true;
+  for (unsigned int i = 0; i < rQueue.size(); ++i) {
+    l_same = l_same and rMaze.isConnected(rQueue[i], from) and
+             (rMaze.getComponentSize(rQueue[i]) == int(rQueue.size()));
+  }
+  return l_same;
+}
+
+//
+// Work out the DynamicMaze's connectivity and distances from source
+// (field 0) again from nothing and check they are what it kept up to
+// date, and that getNextCell goes a step nearer
+//
+static bool sameAsSearch(const Maze::DynamicMaze &rMaze, int source) {
+  const int l_numCells = rMaze.getNumCells();
+  std::vector<int> l_found(l_numCells, -1);
+  std::vector<int> l_distances(l_numCells);
+  std::vector<int> l_queue;
+  l_queue.reserve(l_numCells);
+
+  bool l_same = searchComponent(rMaze, source, l_found, l_distances, l_queue);
+  for (int c = 0; c < l_numCells; ++c) {
+    const int l_distance = (l_found[c] == source)
+                               ? l_distances[c]
+                               : int(Maze::DynamicMaze::UNREACHABLE);
+    l_same = l_same and (rMaze.getDistance(0, c) == l_distance);
+    const int l_next = rMaze.getNextCell(0, c);
+    l_same = l_same and ((l_distance > 0)
+                             ? (rMaze.getDistance(0, l_next) == l_distance - 1)
+                             : (l_next == -1));
+  }
+  for (int c = 0; c < l_numCells; ++c) {
+    if (l_found[c] < 0) {
+      l_same = l_same and
+               searchComponent(rMaze, c, l_found, l_distances, l_queue);
+    }
+  }
+  return l_same;
+}
+
+//
+// Flip random exits and leave them flipped (so the maze splits up and
+// joins again), checking against searching it all again as it goes
+//
+static bool checkToggles(Maze::DynamicMaze &rMaze, int source, int numFlips,
+                         unsigned int seed) {
+  RNG::RandSimple l_rng(seed);
+  bool l_same = sameAsSearch(rMaze, source);
+  for (int n = 1; n <= numFlips; ++n) {
+    const int l_cell =
+        (l_rng.getInt(0, 0x7fff) * 0x8000 + l_rng.getInt(0, 0x7fff)) %
+        rMaze.getNumCells();
+    const int l_exit = l_rng.getInt(0, Maze::SquareGenerator::NUM_EXITS - 1);
+    rMaze.setOpen(l_cell, l_exit, not rMaze.isOpen(l_cell, l_exit));
+    if (n % 50 == 0) {
+      l_same = l_same and sameAsSearch(rMaze, source);
+    }
+  }
+  return l_same;
+}
+
+static void checkDynamicMaze(unsigned int seed) {
+  Maze::PackedMaze *pMaze = Maze::MazeHelper::generateSquarePackedMaze(
+      64, 64, 0, 0, false, false, true, 5, seed);
+  Maze::DynamicMaze l_maze(*pMaze);
+  const int l_source = pMaze->getNumCells() / 2;
+  l_maze.addDistanceField(std::vector<int>(1, l_source));
+  expect(checkToggles(l_maze, l_source, 2000, seed),
+         "DynamicMaze after random toggles differs from a full search");
+  delete pMaze;
+}
+
+//
+// A ChunkedMaze chunk has open exits off the edge (doors) that lead to
+// no cell
+//
+static void checkDynamicChunk(unsigned int seed) {
+  Maze::TileData l_tileData;
+  Maze::MazeHelper::makeSquareTileData(l_tileData);
+  Maze::MazeData l_chunkData(l_tileData, Maze::CellLoc{32, 32},
+                             Maze::CellLoc{0, 0}, false, false, true, 5);
+  Maze::ChunkedMaze l_chunked(l_chunkData, seed, 4);
+  Maze::DynamicMaze l_maze(l_chunked.getChunk(1, -2));
+  l_maze.addDistanceField(std::vector<int>(1, 0));
+  expect(checkToggles(l_maze, 0, 1000, seed),
+         "DynamicMaze of a ChunkedMaze chunk differs from a full search");
+}
+
+//
+// The open masks of a ChunkedMaze chunk, copied as the chunk itself is
+// only valid until it is evicted
+//
+static std::vector<Maze::PackedMaze::ExitMask>
+copyChunk(Maze::ChunkedMaze &rChunked, int chunkX, int chunkY) {
+  const Maze::PackedMaze &l_rChunk = rChunked.getChunk(chunkX, chunkY);
+  return std::vector<Maze::PackedMaze::ExitMask>(
+      l_rChunk.getOpenMasks(),
+      l_rChunk.getOpenMasks() + l_rChunk.getNumCells());
+}
+
+//
+// A ChunkedMaze chunk must be the same whatever order the chunks are
+// made in and when made again after being evicted, and the cells
+// either side of the edge between two chunks must agree on the door
+//
+static void checkChunkedMaze(unsigned int seed) {
+  Maze::TileData l_tileData;
+  Maze::MazeHelper::makeSquareTileData(l_tileData);
+  Maze::MazeData l_chunkData(l_tileData, Maze::CellLoc{24, 16},
+                             Maze::CellLoc{0, 0}, false, false, true, 5);
+  const int NUM_CHUNKS = 9;
+  const int CHUNK_XS[NUM_CHUNKS] = {0, 1, -1, 0, 0, 1, -1, 1, -1};
+  const int CHUNK_YS[NUM_CHUNKS] = {0, 0, 0, 1, -1, 1, -1, -1, 1};
+
+  // Room for 2 so most are evicted before being asked for again
+  Maze::ChunkedMaze l_forward(l_chunkData, seed, 2);
+  Maze::ChunkedMaze l_backward(l_chunkData, seed, 2);
+  std::vector<std::vector<Maze::PackedMaze::ExitMask>> l_chunks;
+  for (int c = 0; c < NUM_CHUNKS; ++c) {
+    l_chunks.push_back(copyChunk(l_forward, CHUNK_XS[c], CHUNK_YS[c]));
+  }
+  bool l_same = true;
+  for (int c = NUM_CHUNKS - 1; c >= 0; --c) {
+    l_same = l_same and (copyChunk(l_backward, CHUNK_XS[c], CHUNK_YS[c]) ==
+                         l_chunks[c]);
+  }
+  // Made again in the first
+  l_same = l_same and (copyChunk(l_forward, CHUNK_XS[0], CHUNK_YS[0]) ==
+                       l_chunks[0]);
+  expect(l_same and (l_forward.getNumResident() == 2) and
+             (l_forward.getNumGenerated() == NUM_CHUNKS + 1),
+         "ChunkedMaze chunk differs when made in another order");
+
+  // Along the edges between the chunks -1..1 both ways
+  const int l_width = l_forward.getChunkWidth();
+  const int l_height = l_forward.getChunkHeight();
+  bool l_agree = true;
+  for (int y = -l_height; y < 2 * l_height; ++y) {
+    for (int x = -1; x < 2; ++x) {
+      const int l_edgeX = x * l_width - 1;
+      l_agree = l_agree and
+                (l_forward.isOpen(l_edgeX, y, Maze::SquareGenerator::EAST) ==
+                 l_backward.isOpen(l_edgeX + 1, y,
+                                   Maze::SquareGenerator::WEST));
+    }
+  }
+  for (int x = -l_width; x < 2 * l_width; ++x) {
+    for (int y = -1; y < 2; ++y) {
+      const int l_edgeY = y * l_height - 1;
+      l_agree = l_agree and
+                (l_forward.isOpen(x, l_edgeY, Maze::SquareGenerator::SOUTH) ==
+                 l_backward.isOpen(x, l_edgeY + 1,
+                                   Maze::SquareGenerator::NORTH));
+    }
+  }
+  expect(l_agree, "ChunkedMaze chunks disagree on a door");
+}
+
+//
+// Every algorithm must finish when the TileData leaves grid locations
+// without a Node (Connections that step 2 => only the even locations)
+//
+static void checkAlgorithmsFinish(unsigned int seed) {
+  Maze::TileData l_tileData;
+  Maze::TileData::Connection l_con;
+  l_con.fromCellType = 0;
+  l_con.toCellType = 0;
+  const int l_changes[4][2] = {{0, -2}, {0, 2}, {2, 0}, {-2, 0}};
+  for (int i = 0; i < 4; ++i) {
+    l_con.locChange = Maze::CellLoc{l_changes[i][0], l_changes[i][1]};
+    l_tileData.defineConnection(l_con);
+  }
+  Maze::MazeData l_mazeData(l_tileData, Maze::CellLoc{4, 4},
+                            Maze::CellLoc{0, 0}, false, false, false, 0);
+  for (int a = Maze::MazeData::ALGO_DEFAULT;
+       a <= Maze::MazeData::ALGO_ALDOUS_BRODER; ++a) {
+    l_mazeData.setAlgorithm(Maze::MazeData::Algorithm(a));
+    RNG::RandSimple l_rng(seed);
+    Maze::Generator l_generator(l_mazeData, &l_rng);
+    Maze::MazeData *pMaze = l_generator.generate(seed);
+    expect(pMaze != 0, "algorithm failed on step 2 tile data");
+    delete pMaze;
+  }
+}
+
+//
+// Wilson's must finish when one way Connections (EAST, WEST and SOUTH
+// but no NORTH) let its walks go where they can't get back to the
+// maze from
+//
+static void checkWilsonOneWay(unsigned int seed) {
+  Maze::TileData l_tileData;
+  Maze::TileData::Connection l_con;
+  l_con.fromCellType = 0;
+  l_con.toCellType = 0;
+  const int l_changes[3][2] = {{1, 0}, {-1, 0}, {0, 1}};
+  for (int i = 0; i < 3; ++i) {
+    l_con.locChange = Maze::CellLoc{l_changes[i][0], l_changes[i][1]};
+    l_tileData.defineConnection(l_con);
+  }
+  Maze::MazeData l_mazeData(l_tileData, Maze::CellLoc{6, 6},
+                            Maze::CellLoc{0, 0}, false, false, false, 0);
+  l_mazeData.setAlgorithm(Maze::MazeData::ALGO_WILSON);
+  RNG::RandSimple l_rng(seed);
+  Maze::Generator l_generator(l_mazeData, &l_rng);
+  Maze::MazeData *pMaze = l_generator.generate(seed);
+  expect(pMaze != 0, "Wilson's failed on one way tile data");
+  delete pMaze;
+}
+
+//
+// CellLocs with more than CellLoc::MAX_DIMS coordinates move to the heap
+// (as std::vector<int> could hold any number), and a maze with that many
+// dimensions generates but can't be stored in a MazeFile
+//
+static void checkManyDims(unsigned int seed) {
+  const int NUM_DIMS = Maze::CellLoc::MAX_DIMS + 2;
+  Maze::CellLoc l_loc;
+  std::vector<int> l_coords;
+  for (int i = 0; i < NUM_DIMS; ++i) {
+    l_loc.push_back(i + 1);
+    l_coords.push_back(i + 1);
+  }
+  Maze::CellLoc l_copy(l_loc);
+  l_copy += l_loc;
+  Maze::CellLoc l_moved(std::move(l_copy));
+  l_copy = l_moved;
+  l_copy.resize(2);
+  expect((l_loc.toVector() == l_coords) and (l_moved.size() == NUM_DIMS) and
+             (l_moved.back() == 2 * NUM_DIMS) and
+             (l_copy == Maze::CellLoc{2, 4}),
+         "CellLoc with more than MAX_DIMS coordinates");
+
+  Maze::TileData l_tileData;
+  Maze::TileData::Connection l_con;
+  l_con.fromCellType = 0;
+  l_con.toCellType = 0;
+  for (int i = 0; i < NUM_DIMS; ++i) {
+    for (int step = -1; step <= 1; step += 2) {
+      l_con.locChange = Maze::CellLoc(NUM_DIMS, 0);
+      l_con.locChange[i] = step;
+      l_tileData.defineConnection(l_con);
+    }
+  }
+  Maze::MazeData l_mazeData(l_tileData, Maze::CellLoc(NUM_DIMS, 3),
+                            Maze::CellLoc(NUM_DIMS, 0), false, false, false,
+                            0);
+  RNG::RandSimple l_rng(seed);
+  Maze::Generator l_generator(l_mazeData, &l_rng);
+  Maze::MazeData *pMaze = l_generator.generate(seed);
+  expect((pMaze != 0) and
+             (Maze::MazeHelper::findNode(*pMaze, Maze::CellLoc(NUM_DIMS, 2)) !=
+              0),
+         "maze with more than MAX_DIMS dimensions");
+  if (pMaze) {
+    expect(not Maze::MazeFile::write(*pMaze, "checkMazeDims.maze"),
+           "MazeFile::write stored more than MAX_DIMS dimensions");
+    std::remove("checkMazeDims.maze");
+  }
+  delete pMaze;
+}
+
+//
+// A maze file with a header value changed to one that is out of range
+// must not be read. The offsets are of the little endian i32s in the
+// header (see MazeFile.h)
+//
+static void putI32(std::vector<char> &rFile, int at, int value) {
+  for (int i = 0; i < 4; ++i) {
+    rFile[at + i] = char((unsigned(value) >> (8 * i)) & 0xff);
+  }
+}
+
+static bool readsFile(const std::vector<char> &rFile) {
+  const std::string l_path = "checkMazeDamaged.maze";
+  {
+    std::ofstream l_out(l_path.c_str(), std::ios::out | std::ios::binary);
+    l_out.write(&rFile[0], rFile.size());
+  }
+  Maze::PackedMaze *pRead = Maze::MazeFile::read(l_path);
+  std::remove(l_path.c_str());
+  delete pRead;
+  return pRead != 0;
+}
+
+static bool readsDamaged(const std::vector<char> &rFile, int at, int value) {
+  std::vector<char> l_damaged(rFile);
+  putI32(l_damaged, at, value);
+  return readsFile(l_damaged);
+}
+
+//
+// numCons more type 0 Connections (to type 0, no change) after the
+// first. Their bytes come out of the padding before the first array
+// (at PAGE_SIZE), so the array offsets stay right
+//
+static bool readsMoreCons(const std::vector<char> &rFile, int numConsAt,
+                          int numCons) {
+  const int CON_BYTES = 4 + 4 + 4 * 4;
+  const int FIRST_ARRAY_AT = 4096;
+  std::vector<char> l_damaged(rFile);
+  int l_numCons = 0;
+  for (int i = 0; i < 4; ++i) {
+    l_numCons |= (unsigned char)rFile[numConsAt + i] << (8 * i);
+  }
+  putI32(l_damaged, numConsAt, l_numCons + numCons);
+  l_damaged.erase(l_damaged.begin() + FIRST_ARRAY_AT - numCons * CON_BYTES,
+                  l_damaged.begin() + FIRST_ARRAY_AT);
+  l_damaged.insert(l_damaged.begin() + numConsAt + 4 + CON_BYTES,
+                   numCons * CON_BYTES, 0);
+  return readsFile(l_damaged);
+}
+
+static void checkMazeFileDamaged(unsigned int seed) {
+  Maze::PackedMaze *pMaze = Maze::MazeHelper::generateSquarePackedMaze(
+      20, 13, 3, 4, false, true, false, 0, seed);
+  const std::string l_path = "checkMaze.maze";
+  expect(Maze::MazeFile::write(*pMaze, l_path), "MazeFile::write failed");
+  std::ifstream l_in(l_path.c_str(), std::ios::in | std::ios::binary);
+  const std::vector<char> l_file((std::istreambuf_iterator<char>(l_in)),
+                                 std::istreambuf_iterator<char>());
+  l_in.close();
+  std::remove(l_path.c_str());
+  delete pMaze;
+
+  const int ALGORITHM_AT = 20;
+  const int START_AT = 28 + 16;
+  const int END_AT = START_AT + 16;
+  const int NUM_CONS_AT = END_AT + 16 + 4;
+  const int FIRST_CHANGE_AT = NUM_CONS_AT + 4 + 8;
+  expect(not l_file.empty() and readsDamaged(l_file, ALGORITHM_AT, 0),
+         "MazeFile::read refused an undamaged file");
+  expect(not readsDamaged(l_file, ALGORITHM_AT, 147),
+         "MazeFile::read took an unknown algorithm");
+  expect(not readsDamaged(l_file, START_AT, 20),
+         "MazeFile::read took a start outside the maze");
+  expect(not readsDamaged(l_file, END_AT + 4, -1),
+         "MazeFile::read took an end outside the maze");
+  expect(not readsDamaged(l_file, FIRST_CHANGE_AT, -2147483647 - 1),
+         "MazeFile::read took a Connection that overflows");
+  expect(readsMoreCons(l_file, NUM_CONS_AT, Maze::PackedMaze::MAX_EXITS - 4),
+         "MazeFile::read refused MAX_EXITS Connections");
+  expect(not readsMoreCons(l_file, NUM_CONS_AT, 36),
+         "MazeFile::read took more than MAX_EXITS Connections");
+
+  Maze::TileData l_tileData;
+  Maze::TileData::Connection l_con;
+  l_con.fromCellType = 0;
+  l_con.toCellType = 0;
+  l_con.locChange = Maze::CellLoc{0, 0};
+  for (int i = 0; i <= Maze::PackedMaze::MAX_EXITS; ++i) {
+    l_tileData.defineConnection(l_con);
+  }
+  Maze::MazeData l_mazeData(l_tileData, Maze::CellLoc{4, 4},
+                            Maze::CellLoc{0, 0}, false, false, false, 0);
+  expect(not Maze::MazeFile::write(l_mazeData, "checkMazeExits.maze"),
+         "MazeFile::write stored more than MAX_EXITS Connections");
+  std::remove("checkMazeExits.maze");
+}
+
+//
+// The tiles GDMaze::make_it used to set, one set_cell at a time (walls,
+// then doors, then smoothing), as a reference for the Rasterizer. Tiles
+// never set are TILE_EMPTY
+//
+struct TileSizes {
+  int m_roomWidth, m_roomHeight;
+  int m_wallWidth, m_wallHeight;
+  int m_doorWidth, m_doorHeight;
+};
+
+static void setTiles(std::vector<unsigned char> &rTiles, int tilesWide,
+                     int x, int y, int width, int height,
+                     unsigned char tile) {
+  for (int cy = 0; cy < height; ++cy) {
+    for (int cx = 0; cx < width; ++cx) {
+      rTiles[size_t(y + cy) * tilesWide + x + cx] = tile;
+    }
+  }
+}
+
+static void makeOldTiles(const Maze::PackedMaze &rMaze, const TileSizes &rSz,
+                         bool smoothWalls, int tilesWide,
+                         std::vector<unsigned char> &rTiles) {
+  const unsigned char WALL = Maze::Rasterizer::TILE_WALL;
+  const unsigned char FLOOR = Maze::Rasterizer::TILE_FLOOR;
+  const int roomsWide = rMaze.getDimensions()[0];
+  const int roomsTall = rMaze.getDimensions()[1];
+  const int stepX = rSz.m_roomWidth + rSz.m_wallWidth;
+  const int stepY = rSz.m_roomHeight + rSz.m_wallHeight;
+
+  // Make a grid of walls
+  for (int ry = 0; ry < roomsTall; ++ry) {
+    for (int rx = 0; rx < roomsWide; ++rx) {
+      const int x = rx * stepX;
+      const int y = ry * stepY;
+      const int outerWidth = rSz.m_wallWidth * 2 + rSz.m_roomWidth;
+      const int outerHeight = rSz.m_wallHeight * 2 + rSz.m_roomHeight;
+      setTiles(rTiles, tilesWide, x, y, outerWidth, rSz.m_wallHeight, WALL);
+      setTiles(rTiles, tilesWide, x, y + stepY, outerWidth, rSz.m_wallHeight,
+               WALL);
+      setTiles(rTiles, tilesWide, x, y, rSz.m_wallWidth, outerHeight, WALL);
+      setTiles(rTiles, tilesWide, x + stepX, y, rSz.m_wallWidth, outerHeight,
+               WALL);
+    }
+  }
+
+  // Delete openings
+  const int offsetX = rSz.m_wallWidth + (rSz.m_roomWidth - rSz.m_doorWidth) / 2;
+  const int offsetY =
+      rSz.m_wallHeight + (rSz.m_roomHeight - rSz.m_doorHeight) / 2;
+  for (int ry = 0, cell = 0; ry < roomsTall; ++ry) {
+    for (int rx = 0; rx < roomsWide; ++rx, ++cell) {
+      const Maze::PackedMaze::Cell l_node = rMaze.getCell(cell);
+      const int x = rx * stepX;
+      const int y = ry * stepY;
+      if (l_node.isOpen(0)) {
+        setTiles(rTiles, tilesWide, x + offsetX, y, rSz.m_doorWidth,
+                 rSz.m_wallHeight, FLOOR);
+      }
+      if (l_node.isOpen(1)) {
+        setTiles(rTiles, tilesWide, x + offsetX, y + stepY, rSz.m_doorWidth,
+                 rSz.m_wallHeight, FLOOR);
+      }
+      if (l_node.isOpen(2)) {
+        setTiles(rTiles, tilesWide, x + stepX, y + offsetY, rSz.m_wallWidth,
+                 rSz.m_doorHeight, FLOOR);
+      }
+      if (l_node.isOpen(3)) {
+        setTiles(rTiles, tilesWide, x, y + offsetY, rSz.m_wallWidth,
+                 rSz.m_doorHeight, FLOOR);
+      }
+    }
+  }
+
+  if (not smoothWalls) {
+    return;
+  }
+  // Remove the nubs between two rooms joined in a line
+  const int nubHeight = (rSz.m_roomHeight - rSz.m_doorHeight) / 2;
+  const int nubWidth = (rSz.m_roomWidth - rSz.m_doorWidth) / 2;
+  for (int ry = 0, cell = 0; ry < roomsTall; ++ry) {
+    for (int rx = 0; rx < roomsWide; ++rx, ++cell) {
+      const Maze::PackedMaze::Cell l_node = rMaze.getCell(cell);
+      if ((rx != roomsWide - 1) and l_node.isOpen(2)) {
+        const Maze::PackedMaze::Cell l_nodeRight = rMaze.getCell(cell + 1);
+        const int x = (rx + 1) * stepX;
+        const int y = ry * stepY + rSz.m_wallHeight;
+        if (l_node.isClosed(0) and l_nodeRight.isClosed(0)) {
+          setTiles(rTiles, tilesWide, x, y, rSz.m_wallWidth, nubHeight, FLOOR);
+        }
+        if (l_node.isClosed(1) and l_nodeRight.isClosed(1)) {
+          setTiles(rTiles, tilesWide, x, y + rSz.m_roomHeight - nubHeight,
+                   rSz.m_wallWidth, nubHeight, FLOOR);
+        }
+      }
+      if ((ry != roomsTall - 1) and l_node.isOpen(1)) {
+        const Maze::PackedMaze::Cell l_nodeBelow =
+            rMaze.getCell(cell + roomsWide);
+        const int x = rx * stepX + rSz.m_wallWidth;
+        const int y = (ry + 1) * stepY;
+        if (l_node.isClosed(3) and l_nodeBelow.isClosed(3)) {
+          setTiles(rTiles, tilesWide, x, y, nubWidth, rSz.m_wallHeight, FLOOR);
+        }
+        if (l_node.isClosed(2) and l_nodeBelow.isClosed(2)) {
+          setTiles(rTiles, tilesWide, x + rSz.m_roomWidth - nubWidth, y,
+                   nubWidth, rSz.m_wallHeight, FLOOR);
+        }
+      }
+    }
+  }
+}
+
+//
+// The Rasterizer must give the tiles the old make_it loops did, with
+// and without wrap round, smoothing and for odd and even sizes
+//
+static void checkRasterizer(unsigned int seed) {
+  const TileSizes l_sizes[] = {{3, 3, 1, 1, 1, 1}, {4, 5, 2, 1, 2, 3},
+                               {5, 4, 1, 3, 1, 2}, {2, 2, 2, 2, 2, 2},
+                               {6, 7, 3, 2, 3, 1}};
+  bool l_same = true;
+  for (int wrap = 0; wrap < 2; ++wrap) {
+    Maze::PackedMaze *pMaze = Maze::MazeHelper::generateSquarePackedMaze(
+        13, 9, 2, 3, wrap, false, false, 20, seed + wrap);
+    for (const TileSizes &rSz : l_sizes) {
+      for (int smooth = 0; smooth < 2; ++smooth) {
+        Maze::Rasterizer l_rasterizer;
+        l_rasterizer.setRoomSize(rSz.m_roomWidth, rSz.m_roomHeight);
+        l_rasterizer.setWallSize(rSz.m_wallWidth, rSz.m_wallHeight);
+        l_rasterizer.setDoorSize(rSz.m_doorWidth, rSz.m_doorHeight);
+        l_rasterizer.setSmoothWalls(smooth);
+        const int tilesWide = l_rasterizer.getWidth(13);
+        const size_t numTiles = size_t(tilesWide) * l_rasterizer.getHeight(9);
+        std::vector<unsigned char> l_tiles(numTiles, 0xff);
+        std::vector<unsigned char> l_oldTiles(numTiles,
+                                              Maze::Rasterizer::TILE_EMPTY);
+        l_same = l_same and l_rasterizer.rasterize(*pMaze, &l_tiles[0]);
+        makeOldTiles(*pMaze, rSz, smooth, tilesWide, l_oldTiles);
+        l_same = l_same and (l_tiles == l_oldTiles);
+      }
+    }
+    delete pMaze;
+  }
+  expect(l_same, "Rasterizer differs from the old make_it tiles");
+}
+
+int main() {
+  const unsigned int seed = 12345;
+
+  checkSolver(256, seed);
+  checkPathOracle(256, seed);
+  checkSquare(512, false, seed);
+  checkSquare(512, true, seed);
+  checkEller(37, 23, seed);
+  checkBatch(128, 16, seed);
+  checkParallel(1024, seed);
+  checkMazeFile(512, seed);
+  checkThreadPool(1024, false, seed);
+  checkThreadPool(1024, true, seed);
+  checkTileDataCompiled();
+  checkCancel(256, seed);
+  checkFindNode(64, seed);
+  checkDynamicMaze(seed);
+  checkDynamicChunk(seed);
+  checkChunkedMaze(seed);
+  checkAlgorithmsFinish(seed);
+  checkWilsonOneWay(seed);
+  checkManyDims(seed);
+  checkMazeFileDamaged(seed);
+  checkRasterizer(seed);
+
+  if (g_numFailed) {
+    std::cerr << g_numFailed << " check(s) failed\n";
+    return 1;
+  }
+  std::cout << "all checks passed\n";
+  return 0;
+}